@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "BinaryMeshWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+  bool hostIsLittleEndian( )
+  {
+    const uint32_t value = 1;
+    uint8_t first;
+    std::memcpy( &first , &value , 1 );
+    return first == 1;
+  }
+
+  /** \brief Writes 32-bit values in little endian order.
+   *
+   */
+  template< typename T >
+  void writeLittleEndian( std::ostream& stream , const T* values ,
+                          size_t count )
+  {
+    static_assert( sizeof( T ) == 4 , "Only 32-bit values are supported" );
+
+    if ( hostIsLittleEndian( ))
+    {
+      stream.write( reinterpret_cast< const char* >( values ) ,
+                    static_cast< std::streamsize >( count * sizeof( T )));
+      return;
+    }
+
+    std::vector< char > swapped( count * sizeof( T ));
+    for ( size_t i = 0; i < count; ++i )
+    {
+      const auto bytes = reinterpret_cast< const char* >( values + i );
+      std::reverse_copy( bytes , bytes + sizeof( T ) , &swapped[ i * sizeof( T )]);
+    }
+    stream.write( swapped.data( ) , static_cast< std::streamsize >( swapped.size( )));
+  }
+
+  /** \brief Writes triangles as PLY faces in blocks, to avoid one stream
+   * call per triangle.
+   *
+   */
+  void writePLYFaces( std::ostream& stream , const uint32_t* indices ,
+                      size_t numTriangles )
+  {
+    constexpr size_t FACES_PER_BLOCK = 4096;
+    constexpr size_t FACE_BYTES = 1 + 3 * sizeof( uint32_t );
+    const bool littleEndian = hostIsLittleEndian( );
+    std::vector< char > block( std::min( FACES_PER_BLOCK , numTriangles ) *
+                               FACE_BYTES );
+    for ( size_t first = 0; first < numTriangles; first += FACES_PER_BLOCK )
+    {
+      const auto count = std::min( FACES_PER_BLOCK , numTriangles - first );
+      for ( size_t face = 0; face < count; ++face )
+      {
+        char* out = &block[ face * FACE_BYTES ];
+        *out++ = 3;
+        for ( size_t corner = 0; corner < 3; ++corner )
+        {
+          const auto index = indices[( first + face ) * 3 + corner ];
+          const auto bytes = reinterpret_cast< const char* >( &index );
+          if ( littleEndian )
+            std::copy( bytes , bytes + 4 , out );
+          else
+            std::reverse_copy( bytes , bytes + 4 , out );
+          out += 4;
+        }
+      }
+      stream.write( block.data( ) ,
+                    static_cast< std::streamsize >( count * FACE_BYTES ));
+    }
+  }
+
+  void writePLYHeader( std::ostream& stream , size_t numVertices ,
+                       size_t numTriangles , const std::string& comment )
+  {
+    stream << "ply\nformat binary_little_endian 1.0\n";
+    std::istringstream lines( comment );
+    std::string line;
+    while ( std::getline( lines , line ))
+    {
+      line.erase( 0 , line.find_first_not_of( "# " ));
+      if ( !line.empty( ))
+        stream << "comment " << line << "\n";
+    }
+    stream << "element vertex " << numVertices << "\n"
+           << "property float x\nproperty float y\nproperty float z\n"
+           << "element face " << numTriangles << "\n"
+           << "property list uchar uint vertex_indices\n"
+           << "end_header\n";
+  }
+
+  /** \brief Writes the GLB header, the JSON chunk and the binary chunk
+   * header, so the positions and indices can be written right after it.
+   *
+   */
+  void writeGLBHeader( std::ostream& stream , size_t numVertices ,
+                       size_t numIndices , const Eigen::Vector3f& minimum ,
+                       const Eigen::Vector3f& maximum )
+  {
+    if ( numVertices == 0 )
+      throw std::runtime_error( "glTF files can't contain empty meshes" );
+
+    const uint64_t positionBytes = numVertices * 3 * sizeof( float );
+    const uint64_t indexBytes = numIndices * sizeof( uint32_t );
+
+    std::ostringstream json;
+    json.precision( std::numeric_limits< float >::max_digits10 );
+    json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"NeuroTessMesh\"},"
+         << "\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+         << "\"nodes\":[{\"mesh\":0}],"
+         << "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},"
+         << "\"indices\":1,\"mode\":4}]}],"
+         << "\"buffers\":[{\"byteLength\":" << positionBytes + indexBytes << "}],"
+         << "\"bufferViews\":["
+         << "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << positionBytes
+         << ",\"target\":34962},"
+         << "{\"buffer\":0,\"byteOffset\":" << positionBytes
+         << ",\"byteLength\":" << indexBytes << ",\"target\":34963}],"
+         << "\"accessors\":["
+         << "{\"bufferView\":0,\"componentType\":5126,\"count\":"
+         << numVertices << ",\"type\":\"VEC3\","
+         << "\"min\":[" << minimum.x( ) << "," << minimum.y( ) << "," << minimum.z( ) << "],"
+         << "\"max\":[" << maximum.x( ) << "," << maximum.y( ) << "," << maximum.z( ) << "]},"
+         << "{\"bufferView\":1,\"componentType\":5125,\"count\":"
+         << numIndices << ",\"type\":\"SCALAR\"}]}";
+
+    // Chunks must be 4-byte aligned, JSON is padded with spaces.
+    std::string jsonChunk = json.str( );
+    jsonChunk.append(( 4 - jsonChunk.size( ) % 4 ) % 4 , ' ' );
+
+    const uint64_t fileLength = 12 + 8 + jsonChunk.size( ) + 8 +
+                                positionBytes + indexBytes;
+    if ( fileLength > std::numeric_limits< uint32_t >::max( ))
+      throw std::runtime_error( "Mesh too big for a glTF binary file" );
+
+    const uint32_t header[ 3 ] = {
+      0x46546C67 , 2 , static_cast< uint32_t >( fileLength )};
+    const uint32_t jsonHeader[ 2 ] = {
+      static_cast< uint32_t >( jsonChunk.size( )) , 0x4E4F534A };
+    const uint32_t binaryHeader[ 2 ] = {
+      static_cast< uint32_t >( positionBytes + indexBytes ) , 0x004E4942 };
+
+    writeLittleEndian( stream , header , 3 );
+    writeLittleEndian( stream , jsonHeader , 2 );
+    stream.write( jsonChunk.data( ) ,
+                  static_cast< std::streamsize >( jsonChunk.size( )));
+    writeLittleEndian( stream , binaryHeader , 2 );
+  }
+
+  void expandBounds( const float* positions , size_t numVertices ,
+                     Eigen::Vector3f& minimum , Eigen::Vector3f& maximum )
+  {
+    for ( size_t i = 0; i < numVertices; ++i )
+    {
+      const Eigen::Map< const Eigen::Vector3f > position( positions + i * 3 );
+      minimum = minimum.cwiseMin( position );
+      maximum = maximum.cwiseMax( position );
+    }
+  }
+
+  void copyStream( std::istream& source , std::ostream& destination )
+  {
+    std::vector< char > block( 1 << 20 );
+    while ( source )
+    {
+      source.read( block.data( ) , static_cast< std::streamsize >( block.size( )));
+      destination.write( block.data( ) , source.gcount( ));
+    }
+  }
+
+  struct PositionHash
+  {
+    size_t operator( )( const std::array< uint32_t , 3 >& key ) const
+    {
+      size_t hash = key[ 0 ];
+      hash = hash * 0x9E3779B1u ^ key[ 1 ];
+      hash = hash * 0x9E3779B1u ^ key[ 2 ];
+      return hash;
+    }
+  };
+}
+
+namespace neurotessmesh
+{
+  IndexedMesh IndexedMesh::fromMesh( const nlgeometry::MeshPtr mesh , bool weld )
+  {
+    IndexedMesh result;
+    result.positions.reserve( mesh->vertices( ).size( ) * 3 );
+    result.indices.reserve( mesh->triangles( ).size( ) * 3 +
+                            mesh->quads( ).size( ) * 6 );
+
+    std::unordered_map< nlgeometry::VertexPtr , uint32_t > instances;
+    std::unordered_map< std::array< uint32_t , 3 > , uint32_t , PositionHash >
+      positions;
+
+    auto index = [ & ]( const nlgeometry::VertexPtr vertex )
+    {
+      const auto instance = instances.find( vertex );
+      if ( instance != instances.end( ))
+        return instance->second;
+
+      const Eigen::Vector3f position = vertex->position( );
+      auto newIndex = static_cast< uint32_t >( result.numVertices( ));
+      if ( weld )
+      {
+        std::array< uint32_t , 3 > key;
+        std::memcpy( key.data( ) , position.data( ) , sizeof( key ));
+        const auto inserted = positions.emplace( key , newIndex );
+        if ( !inserted.second )
+        {
+          instances[ vertex ] = inserted.first->second;
+          return inserted.first->second;
+        }
+      }
+
+      result.positions.push_back( position.x( ));
+      result.positions.push_back( position.y( ));
+      result.positions.push_back( position.z( ));
+      instances[ vertex ] = newIndex;
+      return newIndex;
+    };
+
+    for ( const auto facet: mesh->triangles( ))
+    {
+      const auto& vertices = facet->vertices( );
+      for ( size_t i = 0; i < 3; ++i )
+        result.indices.push_back( index( vertices[ i ]));
+    }
+
+    for ( const auto facet: mesh->quads( ))
+    {
+      const auto& vertices = facet->vertices( );
+      const uint32_t quad[ 4 ] = { index( vertices[ 0 ]) , index( vertices[ 1 ]) ,
+                                   index( vertices[ 2 ]) , index( vertices[ 3 ])};
+      for ( const auto corner: { 0 , 1 , 2 , 0 , 2 , 3 })
+        result.indices.push_back( quad[ corner ]);
+    }
+
+    return result;
+  }
+
+  void IndexedMesh::append( const IndexedMesh& other )
+  {
+    const auto offset = static_cast< uint32_t >( numVertices( ));
+    if ( numVertices( ) + other.numVertices( ) >
+         std::numeric_limits< uint32_t >::max( ))
+      throw std::runtime_error( "Too many vertices for 32-bit indices" );
+
+    positions.insert( positions.end( ) , other.positions.begin( ) ,
+                      other.positions.end( ));
+    indices.reserve( indices.size( ) + other.indices.size( ));
+    for ( const auto index: other.indices )
+      indices.push_back( index + offset );
+  }
+
+  void BinaryMeshWriter::writePLY( const IndexedMesh& mesh ,
+                                   const std::string& fileName ,
+                                   const std::string& comment )
+  {
+    std::ofstream stream( fileName , std::ios::binary | std::ios::trunc );
+    if ( !stream )
+      throw std::runtime_error( "Unable to open " + fileName );
+
+    writePLYHeader( stream , mesh.numVertices( ) , mesh.numTriangles( ) ,
+                    comment );
+    writeLittleEndian( stream , mesh.positions.data( ) , mesh.positions.size( ));
+    writePLYFaces( stream , mesh.indices.data( ) , mesh.numTriangles( ));
+
+    if ( !stream )
+      throw std::runtime_error( "Error writing " + fileName );
+  }
+
+  void BinaryMeshWriter::writeGLB( const IndexedMesh& mesh ,
+                                   const std::string& fileName )
+  {
+    Eigen::Vector3f minimum = Eigen::Vector3f::Constant(
+      std::numeric_limits< float >::max( ));
+    Eigen::Vector3f maximum = Eigen::Vector3f::Constant(
+      std::numeric_limits< float >::lowest( ));
+    expandBounds( mesh.positions.data( ) , mesh.numVertices( ) ,
+                  minimum , maximum );
+
+    std::ofstream stream( fileName , std::ios::binary | std::ios::trunc );
+    if ( !stream )
+      throw std::runtime_error( "Unable to open " + fileName );
+
+    writeGLBHeader( stream , mesh.numVertices( ) , mesh.indices.size( ) ,
+                    minimum , maximum );
+    writeLittleEndian( stream , mesh.positions.data( ) , mesh.positions.size( ));
+    writeLittleEndian( stream , mesh.indices.data( ) , mesh.indices.size( ));
+
+    if ( !stream )
+      throw std::runtime_error( "Error writing " + fileName );
+  }
+
+  StreamingMeshWriter::StreamingMeshWriter( const std::string& fileName ,
+                                            const Format format ,
+                                            const std::string& comment )
+    : _fileName( fileName )
+    , _format( format )
+    , _comment( comment )
+    , _numVertices( 0 )
+    , _numIndices( 0 )
+    , _minimum( Eigen::Vector3f::Constant(
+                  std::numeric_limits< float >::max( )))
+    , _maximum( Eigen::Vector3f::Constant(
+                  std::numeric_limits< float >::lowest( )))
+    , _closed( false )
+  {
+    _positions.open( temporaryName( "positions" ) ,
+                     std::ios::binary | std::ios::trunc );
+    _indices.open( temporaryName( "indices" ) ,
+                   std::ios::binary | std::ios::trunc );
+    if ( !_positions || !_indices )
+    {
+      removeTemporaries( );
+      throw std::runtime_error( "Unable to open " + fileName );
+    }
+  }
+
+  StreamingMeshWriter::~StreamingMeshWriter( )
+  {
+    removeTemporaries( );
+  }
+
+  void StreamingMeshWriter::append( const IndexedMesh& mesh )
+  {
+    if ( _closed )
+      throw std::runtime_error( "Appending to a closed mesh writer" );
+
+    if ( _numVertices + mesh.numVertices( ) >
+         std::numeric_limits< uint32_t >::max( ))
+      throw std::runtime_error( "Too many vertices for 32-bit indices" );
+
+    writeLittleEndian( _positions , mesh.positions.data( ) ,
+                       mesh.positions.size( ));
+    expandBounds( mesh.positions.data( ) , mesh.numVertices( ) ,
+                  _minimum , _maximum );
+
+    // Offsets the indices block by block to keep the copy small.
+    constexpr size_t INDICES_PER_BLOCK = 3 * 4096;
+    const auto offset = static_cast< uint32_t >( _numVertices );
+    std::vector< uint32_t > block;
+    block.reserve( std::min( INDICES_PER_BLOCK , mesh.indices.size( )));
+    for ( size_t first = 0; first < mesh.indices.size( );
+          first += INDICES_PER_BLOCK )
+    {
+      const auto count = std::min( INDICES_PER_BLOCK ,
+                                   mesh.indices.size( ) - first );
+      block.clear( );
+      for ( size_t i = first; i < first + count; ++i )
+        block.push_back( mesh.indices[ i ] + offset );
+
+      if ( _format == PLY )
+        writePLYFaces( _indices , block.data( ) , count / 3 );
+      else
+        writeLittleEndian( _indices , block.data( ) , count );
+    }
+
+    _numVertices += mesh.numVertices( );
+    _numIndices += mesh.indices.size( );
+
+    if ( !_positions || !_indices )
+      throw std::runtime_error( "Error writing " + _fileName );
+  }
+
+  void StreamingMeshWriter::close( )
+  {
+    if ( _closed )
+      return;
+    _closed = true;
+
+    _positions.close( );
+    _indices.close( );
+
+    std::ofstream stream( _fileName , std::ios::binary | std::ios::trunc );
+    if ( !stream )
+      throw std::runtime_error( "Unable to open " + _fileName );
+
+    if ( _format == PLY )
+      writePLYHeader( stream , _numVertices , _numIndices / 3 , _comment );
+    else
+      writeGLBHeader( stream , _numVertices , _numIndices , _minimum , _maximum );
+
+    std::ifstream positions( temporaryName( "positions" ) , std::ios::binary );
+    std::ifstream indices( temporaryName( "indices" ) , std::ios::binary );
+    copyStream( positions , stream );
+    copyStream( indices , stream );
+
+    removeTemporaries( );
+
+    if ( !stream )
+      throw std::runtime_error( "Error writing " + _fileName );
+  }
+
+  std::string StreamingMeshWriter::temporaryName(
+    const std::string& suffix ) const
+  {
+    return _fileName + "." + suffix + ".tmp";
+  }
+
+  void StreamingMeshWriter::removeTemporaries( )
+  {
+    if ( _positions.is_open( ))
+      _positions.close( );
+    if ( _indices.is_open( ))
+      _indices.close( );
+    std::remove( temporaryName( "positions" ).c_str( ));
+    std::remove( temporaryName( "indices" ).c_str( ));
+  }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_BINARYMESHWRITER_H_
+#define NEUROTESSMESH_BINARYMESHWRITER_H_
+
+// neurolots
+#include <nlgeometry/nlgeometry.h>
+
+// C++
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class IndexedMesh
+   * \brief Triangle mesh stored as flat position and 32-bit index arrays,
+   * ready to be written to binary formats.
+   *
+   */
+  class IndexedMesh
+  {
+  public:
+    /** \brief Builds the indexed mesh of an nlgeometry mesh. Quads are split
+     * in two triangles.
+     * \param[in] mesh Source mesh.
+     * \param[in] weld true to merge the vertices with the same position,
+     * otherwise only shared vertex instances are merged.
+     *
+     */
+    static IndexedMesh fromMesh( const nlgeometry::MeshPtr mesh ,
+                                 bool weld = true );
+
+    /** \brief Appends the vertices and triangles of another mesh.
+     * \param[in] other Mesh to append.
+     *
+     */
+    void append( const IndexedMesh& other );
+
+    /** \brief Returns the number of vertices.
+     *
+     */
+    size_t numVertices( ) const
+    { return positions.size( ) / 3; }
+
+    /** \brief Returns the number of triangles.
+     *
+     */
+    size_t numTriangles( ) const
+    { return indices.size( ) / 3; }
+
+    //! Vertex positions, xyz
+    std::vector< float > positions;
+
+    //! Triangle vertex indices
+    std::vector< uint32_t > indices;
+  };
+
+  /** \class BinaryMeshWriter
+   * \brief Writes indexed meshes as little endian binary PLY or glTF 2.0
+   * binary (GLB) files.
+   *
+   */
+  class BinaryMeshWriter
+  {
+  public:
+    /** \brief Writes the mesh as a binary little endian PLY file.
+     * \param[in] mesh Mesh to write.
+     * \param[in] fileName Output filename.
+     * \param[in] comment Header comment, one line per '\n' separated line.
+     * Throws std::runtime_error on failure.
+     *
+     */
+    static void writePLY( const IndexedMesh& mesh ,
+                          const std::string& fileName ,
+                          const std::string& comment = std::string( ));
+
+    /** \brief Writes the mesh as a glTF 2.0 binary file with a single
+     * triangles primitive.
+     * \param[in] mesh Mesh to write.
+     * \param[in] fileName Output filename.
+     * Throws std::runtime_error on failure.
+     *
+     */
+    static void writeGLB( const IndexedMesh& mesh ,
+                          const std::string& fileName );
+  };
+
+  /** \class StreamingMeshWriter
+   * \brief Writes a binary PLY or GLB file from many meshes appended one
+   * after another, without keeping them in memory.
+   *
+   * Positions and indices are spooled to temporary files next to the output
+   * and copied after the header once the totals are known, so memory use
+   * only depends on the largest appended mesh.
+   *
+   */
+  class StreamingMeshWriter
+  {
+  public:
+    enum Format
+    {
+      PLY , GLB
+    };
+
+    /** \brief StreamingMeshWriter class constructor.
+     * \param[in] fileName Output filename.
+     * \param[in] format Output format.
+     * \param[in] comment PLY header comment.
+     * Throws std::runtime_error if the temporary files can't be created.
+     *
+     */
+    StreamingMeshWriter( const std::string& fileName , const Format format ,
+                         const std::string& comment = std::string( ));
+
+    /** \brief StreamingMeshWriter class destructor. Removes the temporary
+     * files.
+     *
+     */
+    ~StreamingMeshWriter( );
+
+    StreamingMeshWriter( const StreamingMeshWriter& ) = delete;
+    StreamingMeshWriter& operator=( const StreamingMeshWriter& ) = delete;
+
+    /** \brief Appends the mesh to the output.
+     * \param[in] mesh Mesh to append.
+     * Throws std::runtime_error on failure.
+     *
+     */
+    void append( const IndexedMesh& mesh );
+
+    /** \brief Writes the output file.
+     * Throws std::runtime_error on failure.
+     *
+     */
+    void close( );
+
+  private:
+    std::string temporaryName( const std::string& suffix ) const;
+
+    void removeTemporaries( );
+
+    std::string _fileName;
+    Format _format;
+    std::string _comment;
+    std::ofstream _positions;
+    std::ofstream _indices;
+    size_t _numVertices;
+    size_t _numIndices;
+    Eigen::Vector3f _minimum;
+    Eigen::Vector3f _maximum;
+    bool _closed;
+  };
+}
+
+#endif /* NEUROTESSMESH_BINARYMESHWRITER_H_ */
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Project
+#include "CameraPathRenderer.h"
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+// ReTo
+#include <reto/reto.h>
+
+namespace neurotessmesh
+{
+  CameraPathRenderer::CameraPathRenderer( OpenGLWidget* widget ,
+                                          const Options& options )
+    : m_widget{ widget }
+    , m_options{ options }
+  { }
+
+  QString CameraPathRenderer::readPositions(
+    const QString& fileName , std::vector< CameraPosition >& positions )
+  {
+    QFile file{ fileName };
+    if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ))
+      return QObject::tr( "Unable to open: %1" ).arg( fileName );
+
+    QJsonParseError parserError;
+    const auto jsonDoc = QJsonDocument::fromJson( file.readAll( ) ,
+                                                  &parserError );
+    if ( jsonDoc.isNull( ) || !jsonDoc.isObject( ))
+      return QObject::tr( "Error parsing %1: %2" ).arg( fileName )
+        .arg( parserError.errorString( ));
+
+    positions.clear( );
+    const auto jsonPositions = jsonDoc.object( ).value( "positions" ).toArray( );
+    for ( const auto value: jsonPositions )
+    {
+      const auto o = value.toObject( );
+      const auto data = o.value( "position" ).toString( ) + ";" +
+                        o.value( "radius" ).toString( ) + ";" +
+                        o.value( "rotation" ).toString( );
+      if ( data.split( ";" ).size( ) != 3 ||
+           data.split( "," ).size( ) != 11 )
+        return QObject::tr( "Invalid camera position '%1' in %2" )
+          .arg( o.value( "name" ).toString( )).arg( fileName );
+
+      positions.emplace_back( data );
+    }
+
+    if ( positions.empty( ))
+      return QObject::tr( "No camera positions in %1" ).arg( fileName );
+
+    return QString( );
+  }
+
+  QString CameraPathRenderer::render( )
+  {
+    std::vector< CameraPosition > positions;
+    auto error = readPositions( m_options.positionsFile , positions );
+    if ( !error.isEmpty( ))
+      return error;
+
+    if ( m_options.fps <= 0.0 || m_options.secondsPerPosition < 0.0 ||
+         m_options.size.isEmpty( ))
+      return QObject::tr( "Invalid frame rate, duration or frame size." );
+
+    if ( !QDir( ).mkpath( m_options.output ))
+      return QObject::tr( "Unable to create %1" ).arg( m_options.output );
+
+    if ( !m_options.encoder.isEmpty( ))
+    {
+      m_encoder.setWorkingDirectory( m_options.output );
+      m_encoder.setProcessChannelMode( QProcess::ForwardedChannels );
+      m_encoder.start( m_options.encoder );
+      if ( !m_encoder.waitForStarted( ))
+        return QObject::tr( "Unable to start encoder: %1" )
+          .arg( m_options.encoder );
+    }
+
+    reto::CameraAnimation animation( reto::CameraAnimation::LINEAR ,
+                                     reto::CameraAnimation::LINEAR ,
+                                     reto::CameraAnimation::LINEAR );
+    for ( size_t i = 0; i < positions.size( ); ++i )
+    {
+      const auto& p = positions[ i ];
+      animation.addKeyCamera( new reto::KeyCamera(
+        static_cast< float >( i * m_options.secondsPerPosition ) ,
+        p.position , p.rotation , p.radius ));
+    }
+
+    const double duration =
+      ( positions.size( ) - 1 ) * m_options.secondsPerPosition;
+    const int frames = static_cast< int >(
+      std::round( duration * m_options.fps )) + 1;
+
+    auto camera = m_widget->getCamera( );
+    if ( camera->isAniming( ))
+      camera->stopAnim( );
+
+    for ( int frame = 0; frame < frames && error.isEmpty( ); ++frame )
+    {
+      // Every frame is evaluated from the start of the animation so the
+      // timestep errors don't accumulate.
+      const double time = std::min( duration , frame / m_options.fps );
+      camera->startAnim( &animation );
+      camera->anim( static_cast< float >( time ));
+
+      const auto image = m_widget->renderImage( m_options.size );
+      if ( image.isNull( ))
+        error = QObject::tr( "Unable to render frame %1." ).arg( frame );
+      else
+        error = writeFrame( image , frame );
+    }
+
+    if ( camera->isAniming( ))
+      camera->stopAnim( );
+
+    const auto writersError = waitWriters( 0 );
+    if ( error.isEmpty( ))
+      error = writersError;
+
+    if ( m_encoder.state( ) != QProcess::NotRunning )
+    {
+      m_encoder.closeWriteChannel( );
+      m_encoder.waitForFinished( -1 );
+      if ( error.isEmpty( ) && ( m_encoder.exitStatus( ) != QProcess::NormalExit ||
+                                 m_encoder.exitCode( ) != 0 ))
+        error = QObject::tr( "Encoder failed with exit code %1." )
+          .arg( m_encoder.exitCode( ));
+    }
+
+    return error;
+  }
+
+  QString CameraPathRenderer::writeFrame( const QImage& image , int index )
+  {
+    if ( m_encoder.state( ) == QProcess::Running )
+    {
+      const auto rgb = image.convertToFormat( QImage::Format_RGB888 );
+      m_encoder.write( QString( "P6\n%1 %2\n255\n" ).arg( rgb.width( ))
+                       .arg( rgb.height( )).toLatin1( ));
+      for ( int row = 0; row < rgb.height( ); ++row )
+        m_encoder.write( reinterpret_cast< const char* >( rgb.constScanLine( row )) ,
+                         rgb.width( ) * 3 );
+
+      // Frames are not queued in memory while the encoder catches up.
+      while ( m_encoder.bytesToWrite( ) > 0 )
+      {
+        if ( !m_encoder.waitForBytesWritten( -1 ))
+          return QObject::tr( "Error writing frame %1 to the encoder." )
+            .arg( index );
+      }
+      return QString( );
+    }
+
+    if ( !m_options.encoder.isEmpty( ))
+      return QObject::tr( "The encoder exited before the end of the sequence." );
+
+    const auto fileName = QDir( m_options.output ).absoluteFilePath(
+      QString( "frame_%1.png" ).arg( index , 5 , 10 , QChar( '0' )));
+    m_writers.push_back( std::async( std::launch::async ,
+      [ image , fileName ]( )
+      {
+        if ( !image.save( fileName , "PNG" ))
+          return QObject::tr( "Unable to save %1" ).arg( fileName );
+        return QString( );
+      }));
+
+    return waitWriters( static_cast< size_t >(
+      std::max( 1 , QThread::idealThreadCount( ))));
+  }
+
+  QString CameraPathRenderer::waitWriters( size_t pending )
+  {
+    QString error;
+    while ( m_writers.size( ) > pending )
+    {
+      const auto writerError = m_writers.front( ).get( );
+      m_writers.pop_front( );
+      if ( error.isEmpty( ))
+        error = writerError;
+    }
+    return error;
+  }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_CAMERAPATHRENDERER_H_
+#define NEUROTESSMESH_CAMERAPATHRENDERER_H_
+
+// Project
+#include "OpenGLWidget.h"
+
+// Qt
+#include <QImage>
+#include <QProcess>
+#include <QSize>
+#include <QString>
+
+// C++
+#include <deque>
+#include <future>
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class CameraPathRenderer
+   * \brief Renders an image sequence along a path of camera positions at a
+   * fixed frame rate, independently of the time each frame takes to render.
+   *
+   * The camera positions are read from a file written by the camera
+   * positions menu and interpolated with a reto::CameraAnimation. Frames are
+   * saved as numbered PNG images or piped as PPM images to the standard
+   * input of an encoder command.
+   *
+   */
+  class CameraPathRenderer
+  {
+  public:
+    struct Options
+    {
+      QString positionsFile;          /** camera positions JSON file.      */
+      QString output;                 /** frames or encoder directory.     */
+      QSize size{ 1920 , 1080 };      /** frame size in pixels.            */
+      double fps = 30.0;              /** frames per second.               */
+      double secondsPerPosition = 2.0; /** time between camera positions.  */
+      QString encoder;                /** encoder command, empty for PNGs. */
+    };
+
+    /** \brief CameraPathRenderer class constructor.
+     * \param[in] widget Widget with the scene to render.
+     * \param[in] options Rendering options.
+     *
+     */
+    explicit CameraPathRenderer( OpenGLWidget* widget ,
+                                 const Options& options );
+
+    /** \brief Renders and writes all the frames.
+     * \returns Error description or empty if none.
+     *
+     */
+    QString render( );
+
+    /** \brief Reads the camera positions of a JSON positions file.
+     * \param[in] fileName Positions filename.
+     * \param[out] positions Camera positions in file order.
+     * \returns Error description or empty if none.
+     *
+     */
+    static QString readPositions( const QString& fileName ,
+                                  std::vector< CameraPosition >& positions );
+
+  private:
+    /** \brief Writes the frame to the encoder or to a numbered image.
+     * \param[in] image Frame image.
+     * \param[in] index Frame number.
+     * \returns Error description or empty if none.
+     *
+     */
+    QString writeFrame( const QImage& image , int index );
+
+    /** \brief Waits for the pending image writers.
+     * \param[in] pending Number of writers that can be left running.
+     * \returns Error description or empty if none.
+     *
+     */
+    QString waitWriters( size_t pending );
+
+    OpenGLWidget* m_widget;                    /** rendering widget.      */
+    const Options m_options;                   /** rendering options.     */
+    QProcess m_encoder;                        /** encoder process.       */
+    std::deque< std::future< QString >> m_writers; /** PNG writers.       */
+  };
+}
+
+#endif /* NEUROTESSMESH_CAMERAPATHRENDERER_H_ */
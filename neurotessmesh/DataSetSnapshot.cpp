@@ -0,0 +1,533 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "DataSetSnapshot.h"
+
+// Qt
+#include <QFile>
+
+// C++
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+using namespace neurotessmesh;
+
+namespace
+{
+  // Layout (all values little-endian, no padding):
+  //   header: magic[8], byteOrder, version, flags, numMorphologies, numNeurons
+  //   per morphology:
+  //     numNodes, numNodes x { x, y, z, radius, id }
+  //     numSomaNodes, numSomaNodes x node index
+  //     numNeurites, per neurite:
+  //       type, numSections, per section (preorder):
+  //         parent section index, numNodes, numNodes x node index
+  //   per neuron: gid, morphology index, layer, morphological type,
+  //               functional type, transform (16 floats, column-major)
+  constexpr char MAGIC[ 8 ] = { 'N' , 'T' , 'M' , 'S' , 'N' , 'A' , 'P' , '\0' };
+  constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+  constexpr uint32_t VERSION = 1;
+  constexpr uint32_t FLAG_SIMPLIFIED = 0x1;
+  constexpr uint32_t NONE = 0xFFFFFFFF;
+
+  // Smallest records: an empty morphology has its three counts, a neuron
+  // has five values and its transform.
+  constexpr size_t MORPHOLOGY_MIN_SIZE = 3 * sizeof( uint32_t );
+  constexpr size_t NEURON_RECORD_SIZE =
+    5 * sizeof( uint32_t ) + 16 * sizeof( float );
+
+  enum TNeuriteCode : uint32_t
+  {
+    BASAL_DENDRITE = 0 , APICAL_DENDRITE , AXON
+  };
+
+  /** \class SnapshotWriter
+   * \brief Helper to write raw values to the snapshot file.
+   *
+   */
+  class SnapshotWriter
+  {
+  public:
+    explicit SnapshotWriter( const std::string& fileName )
+      : m_stream( fileName , std::ios::out | std::ios::binary | std::ios::trunc )
+    {
+      if ( !m_stream.is_open( ))
+        throw std::runtime_error( "Unable to open " + fileName + " for writing" );
+    }
+
+    template< typename T >
+    void put( const T value )
+    {
+      m_stream.write( reinterpret_cast< const char* >( &value ) , sizeof( T ));
+    }
+
+    void putBytes( const void* data , const size_t size )
+    {
+      m_stream.write( reinterpret_cast< const char* >( data ) ,
+                      static_cast< std::streamsize >( size ));
+    }
+
+    void close( )
+    {
+      m_stream.close( );
+      if ( m_stream.fail( ))
+        throw std::runtime_error( "Error writing snapshot file" );
+    }
+
+  private:
+    std::ofstream m_stream;
+  };
+
+  /** \class SnapshotReader
+   * \brief Helper to read values from the mapped snapshot with bounds checks.
+   *
+   */
+  class SnapshotReader
+  {
+  public:
+    SnapshotReader( const uchar* data , const qint64 size )
+      : m_data( data )
+      , m_size( static_cast< size_t >( size ))
+      , m_pos( 0 )
+    { }
+
+    template< typename T >
+    T get( )
+    {
+      T value;
+      getBytes( &value , sizeof( T ));
+      return value;
+    }
+
+    void getBytes( void* destination , const size_t size )
+    {
+      if ( m_size - m_pos < size )
+        throw std::runtime_error( "Snapshot file is truncated or corrupted" );
+      std::memcpy( destination , m_data + m_pos , size );
+      m_pos += size;
+    }
+
+    uint32_t count( const size_t elementSize )
+    {
+      const auto value = get< uint32_t >( );
+      if ( elementSize * value > m_size - m_pos )
+        throw std::runtime_error( "Snapshot file is truncated or corrupted" );
+      return value;
+    }
+
+    size_t remaining( ) const
+    {
+      return m_size - m_pos;
+    }
+
+  private:
+    const uchar* m_data;
+    const size_t m_size;
+    size_t m_pos;
+  };
+
+  void writeMorphology( SnapshotWriter& writer ,
+                        const nsol::NeuronMorphologyPtr morphology )
+  {
+    std::unordered_map< nsol::NodePtr , uint32_t > nodeIndices;
+    std::vector< nsol::NodePtr > nodes;
+
+    auto indexOf = [ &nodeIndices , &nodes ]( const nsol::NodePtr node )
+    {
+      const auto it = nodeIndices.find( node );
+      if ( it != nodeIndices.end( )) return it->second;
+
+      const auto index = static_cast< uint32_t >( nodes.size( ));
+      nodeIndices.emplace( node , index );
+      nodes.push_back( node );
+      return index;
+    };
+
+    // Sections are flattened in preorder so parents always precede children.
+    struct SectionRecord
+    {
+      uint32_t parent;
+      std::vector< uint32_t > nodes;
+    };
+    struct NeuriteRecord
+    {
+      uint32_t type;
+      std::vector< SectionRecord > sections;
+    };
+
+    std::vector< uint32_t > somaNodes;
+    const auto soma = morphology->soma( );
+    if ( soma )
+    {
+      for ( const auto node: soma->nodes( ))
+        somaNodes.push_back( indexOf( node ));
+    }
+
+    std::vector< NeuriteRecord > neurites;
+    for ( const auto neurite: morphology->neurites( ))
+    {
+      NeuriteRecord record;
+      record.type = BASAL_DENDRITE;
+      if ( neurite->neuriteType( ) == nsol::Neurite::AXON )
+      {
+        record.type = AXON;
+      }
+      else
+      {
+        const auto dendrite = dynamic_cast< nsol::Dendrite* >( neurite );
+        if ( dendrite && dendrite->dendriteType( ) == nsol::Dendrite::APICAL )
+          record.type = APICAL_DENDRITE;
+      }
+
+      std::vector< std::pair< nsol::NeuronMorphologySectionPtr , uint32_t >>
+        stack;
+      if ( neurite->firstSection( ))
+        stack.emplace_back( neurite->firstSection( ) , NONE );
+
+      while ( !stack.empty( ))
+      {
+        const auto current = stack.back( );
+        stack.pop_back( );
+
+        const auto index = static_cast< uint32_t >( record.sections.size( ));
+        SectionRecord section;
+        section.parent = current.second;
+        for ( const auto node: current.first->nodes( ))
+          section.nodes.push_back( indexOf( node ));
+        record.sections.push_back( std::move( section ));
+
+        const auto& children = current.first->children( );
+        for ( auto child = children.rbegin( ); child != children.rend( ); ++child )
+        {
+          const auto childSection =
+            dynamic_cast< nsol::NeuronMorphologySectionPtr >( *child );
+          if ( childSection )
+            stack.emplace_back( childSection , index );
+        }
+      }
+
+      neurites.push_back( std::move( record ));
+    }
+
+    writer.put( static_cast< uint32_t >( nodes.size( )));
+    for ( const auto node: nodes )
+    {
+      writer.put( node->point( ).x( ));
+      writer.put( node->point( ).y( ));
+      writer.put( node->point( ).z( ));
+      writer.put( node->radius( ));
+      writer.put( static_cast< int32_t >( node->id( )));
+    }
+
+    writer.put( static_cast< uint32_t >( somaNodes.size( )));
+    writer.putBytes( somaNodes.data( ) , somaNodes.size( ) * sizeof( uint32_t ));
+
+    writer.put( static_cast< uint32_t >( neurites.size( )));
+    for ( const auto& neurite: neurites )
+    {
+      writer.put( neurite.type );
+      writer.put( static_cast< uint32_t >( neurite.sections.size( )));
+      for ( const auto& section: neurite.sections )
+      {
+        writer.put( section.parent );
+        writer.put( static_cast< uint32_t >( section.nodes.size( )));
+        writer.putBytes( section.nodes.data( ) ,
+                         section.nodes.size( ) * sizeof( uint32_t ));
+      }
+    }
+  }
+
+  /** \brief Reads a morphology, freeing everything read so far on error.
+   *
+   * Nodes may be shared by the soma and several sections, so they stay owned
+   * here until the whole morphology is read. Sections and neurites are owned
+   * until linked to their parent, and the morphology owns the rest.
+   *
+   */
+  std::unique_ptr< nsol::NeuronMorphology >
+  readMorphology( SnapshotReader& reader )
+  {
+    constexpr size_t NODE_RECORD_SIZE = 4 * sizeof( float ) + sizeof( int32_t );
+
+    const auto numNodes = reader.count( NODE_RECORD_SIZE );
+    std::vector< std::unique_ptr< nsol::Node >> nodes;
+    nodes.reserve( numNodes );
+    for ( uint32_t i = 0; i < numNodes; ++i )
+    {
+      const auto x = reader.get< float >( );
+      const auto y = reader.get< float >( );
+      const auto z = reader.get< float >( );
+      const auto radius = reader.get< float >( );
+      const auto id = reader.get< int32_t >( );
+      nodes.emplace_back(
+        new nsol::Node( nsol::Vec3f( x , y , z ) , id , radius ));
+    }
+
+    auto nodeAt = [ &nodes ]( const uint32_t index )
+    {
+      if ( index >= nodes.size( ))
+        throw std::runtime_error( "Snapshot file has an invalid node index" );
+      return nodes[ index ].get( );
+    };
+
+    auto* soma = new nsol::Soma( );
+    std::unique_ptr< nsol::NeuronMorphology > morphology(
+      new nsol::NeuronMorphology( soma ));
+
+    const auto numSomaNodes = reader.count( sizeof( uint32_t ));
+    for ( uint32_t i = 0; i < numSomaNodes; ++i )
+      soma->addNode( nodeAt( reader.get< uint32_t >( )));
+
+    const auto numNeurites = reader.count( 2 * sizeof( uint32_t ));
+    for ( uint32_t i = 0; i < numNeurites; ++i )
+    {
+      const auto type = reader.get< uint32_t >( );
+      std::unique_ptr< nsol::Neurite > neurite;
+      switch ( type )
+      {
+        case AXON:
+          neurite.reset( new nsol::Axon( ));
+          break;
+        case APICAL_DENDRITE:
+          neurite.reset( new nsol::Dendrite( nsol::Dendrite::APICAL ));
+          break;
+        case BASAL_DENDRITE:
+          neurite.reset( new nsol::Dendrite( nsol::Dendrite::BASAL ));
+          break;
+        default:
+          throw std::runtime_error( "Snapshot file has an invalid neurite type" );
+      }
+
+      const auto numSections = reader.count( 2 * sizeof( uint32_t ));
+      std::vector< nsol::NeuronMorphologySectionPtr > sections;
+      sections.reserve( numSections );
+      for ( uint32_t j = 0; j < numSections; ++j )
+      {
+        const auto parent = reader.get< uint32_t >( );
+        if ( parent == NONE && j != 0 )
+          throw std::runtime_error( "Snapshot file has an orphan section" );
+        if ( parent != NONE && parent >= j )
+          throw std::runtime_error( "Snapshot file has an invalid section" );
+
+        std::unique_ptr< nsol::NeuronMorphologySection > section(
+          new nsol::NeuronMorphologySection( ));
+
+        const auto numSectionNodes = reader.count( sizeof( uint32_t ));
+        for ( uint32_t k = 0; k < numSectionNodes; ++k )
+          section->addNode( nodeAt( reader.get< uint32_t >( )));
+
+        if ( parent == NONE )
+        {
+          neurite->firstSection( section.get( ));
+        }
+        else
+        {
+          section->parent( sections[ parent ] );
+          sections[ parent ]->addChild( section.get( ));
+        }
+        sections.push_back( section.release( ));
+      }
+
+      morphology->addNeurite( neurite.release( ));
+    }
+
+    for ( auto& node: nodes )
+      node.release( );
+
+    return morphology;
+  }
+
+  /** \class MappedFile
+   * \brief Unmaps the snapshot when leaving the scope, even on error.
+   *
+   */
+  class MappedFile
+  {
+  public:
+    MappedFile( QFile& file , uchar* data )
+      : m_file( file )
+      , m_data( data )
+    { }
+
+    ~MappedFile( )
+    {
+      m_file.unmap( m_data );
+    }
+
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+  private:
+    QFile& m_file;
+    uchar* m_data;
+  };
+}
+
+void DataSetSnapshot::save( const nsol::NeuronsMap& neurons ,
+                            const std::string& fileName ,
+                            const bool simplified )
+{
+  std::unordered_map< nsol::NeuronMorphologyPtr , uint32_t > morphologyIndices;
+  std::vector< nsol::NeuronMorphologyPtr > morphologies;
+
+  for ( const auto& neuron: neurons )
+  {
+    const auto morphology = neuron.second->morphology( );
+    if ( morphology && morphologyIndices.find( morphology ) ==
+                       morphologyIndices.end( ))
+    {
+      morphologyIndices.emplace( morphology ,
+                                 static_cast< uint32_t >( morphologies.size( )));
+      morphologies.push_back( morphology );
+    }
+  }
+
+  SnapshotWriter writer( fileName );
+  writer.putBytes( MAGIC , sizeof( MAGIC ));
+  writer.put( BYTE_ORDER_MARK );
+  writer.put( VERSION );
+  writer.put( simplified ? FLAG_SIMPLIFIED : 0u );
+  writer.put( static_cast< uint32_t >( morphologies.size( )));
+  writer.put( static_cast< uint32_t >( neurons.size( )));
+
+  for ( const auto morphology: morphologies )
+    writeMorphology( writer , morphology );
+
+  for ( const auto& neuron: neurons )
+  {
+    const auto morphology = neuron.second->morphology( );
+    const Eigen::Matrix4f transform = neuron.second->transform( );
+
+    writer.put( static_cast< uint32_t >( neuron.first ));
+    writer.put( morphology ? morphologyIndices[ morphology ] : NONE );
+    writer.put( static_cast< uint32_t >( neuron.second->layer( )));
+    writer.put( static_cast< uint32_t >( neuron.second->morphologicalType( )));
+    writer.put( static_cast< uint32_t >( neuron.second->functionalType( )));
+    writer.putBytes( transform.data( ) , 16 * sizeof( float ));
+  }
+
+  writer.close( );
+}
+
+bool DataSetSnapshot::load( const std::string& fileName ,
+                            nsol::DataSet* dataset )
+{
+  QFile file( QString::fromStdString( fileName ));
+  if ( !file.open( QIODevice::ReadOnly ))
+    throw std::runtime_error( "Unable to open " + fileName );
+
+  const auto size = file.size( );
+  const auto data = file.map( 0 , size );
+  if ( !data )
+    throw std::runtime_error( "Unable to map " + fileName );
+
+  const MappedFile mapped( file , data );
+  SnapshotReader reader( data , size );
+
+  char magic[ sizeof( MAGIC ) ];
+  reader.getBytes( magic , sizeof( magic ));
+  if ( std::memcmp( magic , MAGIC , sizeof( MAGIC )) != 0 )
+    throw std::runtime_error( fileName + " is not a NeuroTessMesh snapshot" );
+
+  if ( reader.get< uint32_t >( ) != BYTE_ORDER_MARK )
+    throw std::runtime_error( "Snapshot byte order not supported" );
+
+  if ( reader.get< uint32_t >( ) != VERSION )
+    throw std::runtime_error( "Snapshot version not supported" );
+
+  const auto flags = reader.get< uint32_t >( );
+  const auto numMorphologies = reader.get< uint32_t >( );
+  const auto numNeurons = reader.get< uint32_t >( );
+
+  // Both counts must fit in the rest of the file before reserving anything.
+  if ( static_cast< uint64_t >( numMorphologies ) * MORPHOLOGY_MIN_SIZE +
+       static_cast< uint64_t >( numNeurons ) * NEURON_RECORD_SIZE >
+       reader.remaining( ))
+    throw std::runtime_error( "Snapshot file is truncated or corrupted" );
+
+  std::vector< std::unique_ptr< nsol::NeuronMorphology >> morphologies;
+  morphologies.reserve( numMorphologies );
+  for ( uint32_t i = 0; i < numMorphologies; ++i )
+    morphologies.push_back( readMorphology( reader ));
+
+  // Neuron records are all read and checked before adding any neuron, so a
+  // corrupted file leaves the dataset untouched.
+  struct NeuronRecord
+  {
+    uint32_t gid;
+    uint32_t morphology;
+    uint32_t layer;
+    uint32_t morphologicalType;
+    uint32_t functionalType;
+    float transform[ 16 ];
+  };
+  std::vector< NeuronRecord > records( numNeurons );
+  for ( auto& record: records )
+  {
+    record.gid = reader.get< uint32_t >( );
+    record.morphology = reader.get< uint32_t >( );
+    record.layer = reader.get< uint32_t >( );
+    record.morphologicalType = reader.get< uint32_t >( );
+    record.functionalType = reader.get< uint32_t >( );
+    reader.getBytes( record.transform , sizeof( record.transform ));
+
+    if ( record.morphology != NONE &&
+         record.morphology >= morphologies.size( ))
+      throw std::runtime_error( "Snapshot file has an invalid morphology" );
+  }
+
+  std::vector< bool > referenced( morphologies.size( ) , false );
+  for ( const auto& record: records )
+  {
+    nsol::NeuronMorphologyPtr morphology = nullptr;
+    if ( record.morphology != NONE )
+    {
+      morphology = morphologies[ record.morphology ].get( );
+      referenced[ record.morphology ] = true;
+    }
+
+    const Eigen::Matrix4f transform =
+      Eigen::Map< const Eigen::Matrix4f >( record.transform );
+
+    std::unique_ptr< nsol::Neuron > neuron( new nsol::Neuron(
+      morphology ,
+      static_cast< unsigned short >( record.layer ) ,
+      record.gid ,
+      transform ,
+      nullptr ,
+      static_cast< nsol::Neuron::TMorphologicalType >(
+        record.morphologicalType ) ,
+      static_cast< nsol::Neuron::TFunctionalType >( record.functionalType )));
+
+    dataset->addNeuron( neuron.release( ));
+  }
+
+  // Morphologies used by a neuron belong to the dataset now, the rest are
+  // freed with their owners.
+  for ( size_t i = 0; i < morphologies.size( ); ++i )
+    if ( referenced[ i ] )
+      morphologies[ i ].release( );
+
+  return ( flags & FLAG_SIMPLIFIED ) != 0;
+}
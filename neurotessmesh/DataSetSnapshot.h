@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_DATASETSNAPSHOT_H_
+#define NEUROTESSMESH_DATASETSNAPSHOT_H_
+
+// NSOL
+#include <nsol/nsol.h>
+
+// C++
+#include <string>
+
+namespace neurotessmesh
+{
+  /** \class DataSetSnapshot
+   * \brief Reads and writes a compact binary image of a loaded dataset.
+   *
+   * The snapshot stores the neurons (gid, transform, layer, morphological and
+   * functional types) and every distinct morphology only once, already
+   * simplified, so reopening it skips parsing the original sources and the
+   * morphology simplification step. Snapshots are read through a memory
+   * mapping of the file and don't require Brion.
+   *
+   */
+  class DataSetSnapshot
+  {
+  public:
+    /** \brief Default file extension of the snapshot files.
+     *
+     */
+    static constexpr const char* EXTENSION = "ntms";
+
+    /** \brief Writes the given neurons to a snapshot file.
+     * \param[in] neurons Neurons to store.
+     * \param[in] fileName Snapshot filename.
+     * \param[in] simplified true if the morphologies have already been
+     * simplified for meshing.
+     * Throws std::runtime_error on failure.
+     *
+     */
+    static void save( const nsol::NeuronsMap& neurons ,
+                      const std::string& fileName ,
+                      bool simplified = true );
+
+    /** \brief Loads a snapshot file into the given dataset.
+     * \param[in] fileName Snapshot filename.
+     * \param[in] dataset Dataset to fill.
+     * \returns true if the stored morphologies are already simplified.
+     * Throws std::runtime_error on failure.
+     *
+     */
+    static bool load( const std::string& fileName , nsol::DataSet* dataset );
+  };
+}
+
+#endif /* NEUROTESSMESH_DATASETSNAPSHOT_H_ */
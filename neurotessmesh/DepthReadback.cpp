@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "DepthReadback.h"
+#include "OcclusionCuller.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  //! Texels per side of the blocks reduced to one depth
+  const int REDUCTION = 4;
+
+  // Full screen triangle generated from the vertex ids
+  const char* const VERTEX_SHADER = R"(#version 330 core
+void main( )
+{
+  vec2 uv = vec2(( gl_VertexID << 1 ) & 2 , gl_VertexID & 2 );
+  gl_Position = vec4( uv * 2.0 - 1.0 , 0.0 , 1.0 );
+})";
+
+  // Farthest depth of the block, so the reduced buffer stays conservative
+  const char* const FRAGMENT_SHADER = R"(#version 330 core
+uniform sampler2D depthTexture;
+uniform ivec2 sourceSize;
+uniform int reduction;
+void main( )
+{
+  ivec2 origin = ivec2( gl_FragCoord.xy ) * reduction;
+  float depth = 0.0;
+  for ( int y = 0; y < reduction; ++y )
+    for ( int x = 0; x < reduction; ++x )
+    {
+      ivec2 texel = min( origin + ivec2( x , y ) , sourceSize - 1 );
+      depth = max( depth , texelFetch( depthTexture , texel , 0 ).r );
+    }
+  gl_FragDepth = depth;
+})";
+
+  GLuint compileShader( GLenum type , const char* source )
+  {
+    const auto shader = glCreateShader( type );
+    glShaderSource( shader , 1 , &source , nullptr );
+    glCompileShader( shader );
+
+    GLint status = GL_FALSE;
+    glGetShaderiv( shader , GL_COMPILE_STATUS , &status );
+    if ( status != GL_TRUE )
+    {
+      GLint length = 0;
+      glGetShaderiv( shader , GL_INFO_LOG_LENGTH , &length );
+      std::vector< char > log( static_cast< size_t >( std::max( length , 1 )));
+      glGetShaderInfoLog( shader , length , nullptr , log.data( ));
+      std::cerr << "Depth readback shader error: " << log.data( ) << std::endl;
+      glDeleteShader( shader );
+      return 0;
+    }
+    return shader;
+  }
+
+  // Depth blits need the same format in both framebuffers
+  GLenum depthFormat( GLint framebuffer )
+  {
+    const GLenum depth = framebuffer ? GL_DEPTH_ATTACHMENT : GL_DEPTH;
+    const GLenum stencil = framebuffer ? GL_STENCIL_ATTACHMENT : GL_STENCIL;
+
+    GLint object = GL_NONE;
+    glGetFramebufferAttachmentParameteriv(
+      GL_DRAW_FRAMEBUFFER , depth , GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE ,
+      &object );
+    if ( object == GL_NONE )
+      return GL_NONE;
+
+    GLint depthSize = 0 , componentType = GL_UNSIGNED_NORMALIZED;
+    glGetFramebufferAttachmentParameteriv(
+      GL_DRAW_FRAMEBUFFER , depth , GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE ,
+      &depthSize );
+    glGetFramebufferAttachmentParameteriv(
+      GL_DRAW_FRAMEBUFFER , depth , GL_FRAMEBUFFER_ATTACHMENT_COMPONENT_TYPE ,
+      &componentType );
+
+    GLint stencilSize = 0;
+    glGetFramebufferAttachmentParameteriv(
+      GL_DRAW_FRAMEBUFFER , stencil , GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE ,
+      &object );
+    if ( object != GL_NONE )
+      glGetFramebufferAttachmentParameteriv(
+        GL_DRAW_FRAMEBUFFER , stencil , GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE ,
+        &stencilSize );
+
+    const bool floating = componentType == GL_FLOAT;
+    if ( stencilSize > 0 )
+      return floating ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8;
+    if ( floating )
+      return GL_DEPTH_COMPONENT32F;
+    if ( depthSize == 16 )
+      return GL_DEPTH_COMPONENT16;
+    if ( depthSize == 32 )
+      return GL_DEPTH_COMPONENT32;
+    return GL_DEPTH_COMPONENT24;
+  }
+}
+
+namespace neurotessmesh
+{
+  DepthReadback::DepthReadback( )
+    : _program( 0 )
+    , _vertexArray( 0 )
+    , _sourceSizeLocation( -1 )
+    , _resolveFramebuffer( 0 )
+    , _resolveTexture( 0 )
+    , _reducedFramebuffer( 0 )
+    , _reducedDepth( 0 )
+    , _width( 0 )
+    , _height( 0 )
+    , _depthFormat( GL_NONE )
+    , _failed( false )
+    , _next( 0 )
+  {
+    for ( auto& read: _reads )
+      read = Read{ 0 , 0 , nullptr , 0 , 0 , Eigen::Matrix4f::Identity( )};
+  }
+
+  bool DepthReadback::read( const Eigen::Matrix4f& viewProjection )
+  {
+    if ( !initialize( ))
+      return false;
+
+    GLint viewport[ 4 ];
+    glGetIntegerv( GL_VIEWPORT , viewport );
+    GLint drawFramebuffer = 0 , readFramebuffer = 0;
+    glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING , &drawFramebuffer );
+    glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING , &readFramebuffer );
+
+    while ( glGetError( ) != GL_NO_ERROR );
+
+    _depthFormat = depthFormat( drawFramebuffer );
+    if ( !resize( viewport[ 2 ] , viewport[ 3 ]))
+      return false;
+    const auto reducedWidth = ( _width + REDUCTION - 1 ) / REDUCTION;
+    const auto reducedHeight = ( _height + REDUCTION - 1 ) / REDUCTION;
+
+    GLint program = 0 , vertexArray = 0 , texture = 0 , activeTexture = 0;
+    GLint depthFunction = GL_LESS , pixelBuffer = 0;
+    GLboolean depthMask = GL_TRUE;
+    glGetIntegerv( GL_CURRENT_PROGRAM , &program );
+    glGetIntegerv( GL_VERTEX_ARRAY_BINDING , &vertexArray );
+    glGetIntegerv( GL_ACTIVE_TEXTURE , &activeTexture );
+    glActiveTexture( GL_TEXTURE0 );
+    glGetIntegerv( GL_TEXTURE_BINDING_2D , &texture );
+    glGetIntegerv( GL_DEPTH_FUNC , &depthFunction );
+    glGetBooleanv( GL_DEPTH_WRITEMASK , &depthMask );
+    glGetIntegerv( GL_PIXEL_PACK_BUFFER_BINDING , &pixelBuffer );
+    const auto depthTest = glIsEnabled( GL_DEPTH_TEST );
+    const auto cullFace = glIsEnabled( GL_CULL_FACE );
+
+    // Multisampled depth can only be copied at the same size
+    glBindFramebuffer( GL_READ_FRAMEBUFFER ,
+                       static_cast< GLuint >( drawFramebuffer ));
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER , _resolveFramebuffer );
+    glBlitFramebuffer( viewport[ 0 ] , viewport[ 1 ] ,
+                       viewport[ 0 ] + _width , viewport[ 1 ] + _height ,
+                       0 , 0 , _width , _height ,
+                       GL_DEPTH_BUFFER_BIT , GL_NEAREST );
+
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER , _reducedFramebuffer );
+    glViewport( 0 , 0 , reducedWidth , reducedHeight );
+    glEnable( GL_DEPTH_TEST );
+    glDepthFunc( GL_ALWAYS );
+    glDepthMask( GL_TRUE );
+    glDisable( GL_CULL_FACE );
+    glUseProgram( _program );
+    glUniform2i( _sourceSizeLocation , _width , _height );
+    glBindTexture( GL_TEXTURE_2D , _resolveTexture );
+    glBindVertexArray( _vertexArray );
+    glDrawArrays( GL_TRIANGLES , 0 , 3 );
+
+    // The pixel buffer is mapped by collect in a later frame
+    auto& read = _reads[ _next ];
+    _next = ( _next + 1 ) % READS;
+    if ( read.fence )
+      glDeleteSync( static_cast< GLsync >( read.fence ));
+    if ( !read.buffer )
+      glGenBuffers( 1 , &read.buffer );
+    read.width = static_cast< unsigned int >( reducedWidth );
+    read.height = static_cast< unsigned int >( reducedHeight );
+    read.viewProjection = viewProjection;
+    const auto size = read.width * read.height *
+                      static_cast< unsigned int >( sizeof( float ));
+    glBindBuffer( GL_PIXEL_PACK_BUFFER , read.buffer );
+    if ( read.size != size )
+    {
+      glBufferData( GL_PIXEL_PACK_BUFFER , size , nullptr , GL_STREAM_READ );
+      read.size = size;
+    }
+    glBindFramebuffer( GL_READ_FRAMEBUFFER , _reducedFramebuffer );
+    glReadPixels( 0 , 0 , reducedWidth , reducedHeight ,
+                  GL_DEPTH_COMPONENT , GL_FLOAT , nullptr );
+    read.fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE , 0 );
+
+    glBindBuffer( GL_PIXEL_PACK_BUFFER , static_cast< GLuint >( pixelBuffer ));
+    glBindFramebuffer( GL_READ_FRAMEBUFFER ,
+                       static_cast< GLuint >( readFramebuffer ));
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER ,
+                       static_cast< GLuint >( drawFramebuffer ));
+    glViewport( viewport[ 0 ] , viewport[ 1 ] , viewport[ 2 ] , viewport[ 3 ]);
+    glBindVertexArray( static_cast< GLuint >( vertexArray ));
+    glBindTexture( GL_TEXTURE_2D , static_cast< GLuint >( texture ));
+    glActiveTexture( static_cast< GLenum >( activeTexture ));
+    glUseProgram( static_cast< GLuint >( program ));
+    glDepthFunc( static_cast< GLenum >( depthFunction ));
+    glDepthMask( depthMask );
+    if ( !depthTest )
+      glDisable( GL_DEPTH_TEST );
+    if ( cullFace )
+      glEnable( GL_CULL_FACE );
+
+    if ( glGetError( ) != GL_NO_ERROR )
+    {
+      std::cerr << "Depth readback not available" << std::endl;
+      release( );
+      _failed = true;
+      return false;
+    }
+    return true;
+  }
+
+  bool DepthReadback::collect( OcclusionCuller& culler )
+  {
+    // Newest finished read, the older ones are superseded by it
+    int newest = -1;
+    for ( unsigned int i = 0; i < READS; ++i )
+    {
+      const auto index = ( _next + i ) % READS;
+      if ( !_reads[ index ].fence )
+        continue;
+      const auto status = glClientWaitSync(
+        static_cast< GLsync >( _reads[ index ].fence ) , 0 , 0 );
+      if ( status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED )
+        newest = static_cast< int >( index );
+    }
+    if ( newest < 0 )
+      return false;
+
+    for ( unsigned int i = 0; i < READS; ++i )
+    {
+      const auto index = ( _next + i ) % READS;
+      if ( _reads[ index ].fence )
+      {
+        glDeleteSync( static_cast< GLsync >( _reads[ index ].fence ));
+        _reads[ index ].fence = nullptr;
+      }
+      if ( index == static_cast< unsigned int >( newest ))
+        break;
+    }
+
+    const auto& read = _reads[ newest ];
+    GLint pixelBuffer = 0;
+    glGetIntegerv( GL_PIXEL_PACK_BUFFER_BINDING , &pixelBuffer );
+    glBindBuffer( GL_PIXEL_PACK_BUFFER , read.buffer );
+    const auto data = glMapBufferRange( GL_PIXEL_PACK_BUFFER , 0 , read.size ,
+                                        GL_MAP_READ_BIT );
+    if ( data )
+    {
+      auto& depth = culler.depthBuffer( read.width , read.height );
+      std::memcpy( depth.data( ) , data , read.size );
+      glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+      culler.update( read.viewProjection );
+    }
+    glBindBuffer( GL_PIXEL_PACK_BUFFER , static_cast< GLuint >( pixelBuffer ));
+    return data != nullptr;
+  }
+
+  void DepthReadback::release( )
+  {
+    for ( auto& read: _reads )
+    {
+      if ( read.fence )
+        glDeleteSync( static_cast< GLsync >( read.fence ));
+      if ( read.buffer )
+        glDeleteBuffers( 1 , &read.buffer );
+      read.fence = nullptr;
+      read.buffer = read.size = 0;
+    }
+    if ( _resolveFramebuffer )
+      glDeleteFramebuffers( 1 , &_resolveFramebuffer );
+    if ( _reducedFramebuffer )
+      glDeleteFramebuffers( 1 , &_reducedFramebuffer );
+    if ( _resolveTexture )
+      glDeleteTextures( 1 , &_resolveTexture );
+    if ( _reducedDepth )
+      glDeleteRenderbuffers( 1 , &_reducedDepth );
+    if ( _vertexArray )
+      glDeleteVertexArrays( 1 , &_vertexArray );
+    if ( _program )
+      glDeleteProgram( _program );
+
+    _resolveFramebuffer = _reducedFramebuffer = 0;
+    _resolveTexture = _reducedDepth = 0;
+    _vertexArray = _program = 0;
+    _width = _height = 0;
+  }
+
+  bool DepthReadback::initialize( )
+  {
+    if ( _program )
+      return true;
+    if ( _failed )
+      return false;
+
+    const auto vertexShader = compileShader( GL_VERTEX_SHADER , VERTEX_SHADER );
+    const auto fragmentShader =
+      compileShader( GL_FRAGMENT_SHADER , FRAGMENT_SHADER );
+    if ( !vertexShader || !fragmentShader )
+    {
+      glDeleteShader( vertexShader );
+      glDeleteShader( fragmentShader );
+      _failed = true;
+      return false;
+    }
+
+    _program = glCreateProgram( );
+    glAttachShader( _program , vertexShader );
+    glAttachShader( _program , fragmentShader );
+    glLinkProgram( _program );
+    glDeleteShader( vertexShader );
+    glDeleteShader( fragmentShader );
+
+    GLint status = GL_FALSE;
+    glGetProgramiv( _program , GL_LINK_STATUS , &status );
+    if ( status != GL_TRUE )
+    {
+      std::cerr << "Depth readback shader link error" << std::endl;
+      glDeleteProgram( _program );
+      _program = 0;
+      _failed = true;
+      return false;
+    }
+
+    GLint program = 0;
+    glGetIntegerv( GL_CURRENT_PROGRAM , &program );
+    glUseProgram( _program );
+    glUniform1i( glGetUniformLocation( _program , "depthTexture" ) , 0 );
+    glUniform1i( glGetUniformLocation( _program , "reduction" ) , REDUCTION );
+    _sourceSizeLocation = glGetUniformLocation( _program , "sourceSize" );
+    glUseProgram( static_cast< GLuint >( program ));
+
+    // Core profiles need a vertex array even without attributes
+    glGenVertexArrays( 1 , &_vertexArray );
+    return true;
+  }
+
+  bool DepthReadback::resize( int width , int height )
+  {
+    if ( width <= 0 || height <= 0 || _depthFormat == GL_NONE )
+      return false;
+
+    GLint format = GL_NONE;
+    if ( _resolveTexture )
+    {
+      GLint texture = 0;
+      glGetIntegerv( GL_TEXTURE_BINDING_2D , &texture );
+      glBindTexture( GL_TEXTURE_2D , _resolveTexture );
+      glGetTexLevelParameteriv( GL_TEXTURE_2D , 0 , GL_TEXTURE_INTERNAL_FORMAT ,
+                                &format );
+      glBindTexture( GL_TEXTURE_2D , static_cast< GLuint >( texture ));
+    }
+    if ( _resolveFramebuffer && width == _width && height == _height &&
+         static_cast< unsigned int >( format ) == _depthFormat )
+      return true;
+
+    if ( !_resolveFramebuffer )
+    {
+      glGenFramebuffers( 1 , &_resolveFramebuffer );
+      glGenFramebuffers( 1 , &_reducedFramebuffer );
+      glGenTextures( 1 , &_resolveTexture );
+      glGenRenderbuffers( 1 , &_reducedDepth );
+    }
+
+    const bool stencil = _depthFormat == GL_DEPTH24_STENCIL8 ||
+                         _depthFormat == GL_DEPTH32F_STENCIL8;
+    GLint texture = 0;
+    glGetIntegerv( GL_TEXTURE_BINDING_2D , &texture );
+    glBindTexture( GL_TEXTURE_2D , _resolveTexture );
+    glTexImage2D( GL_TEXTURE_2D , 0 , static_cast< GLint >( _depthFormat ) ,
+                  width , height , 0 ,
+                  stencil ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT ,
+                  _depthFormat == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 :
+                  _depthFormat == GL_DEPTH32F_STENCIL8 ?
+                    GL_FLOAT_32_UNSIGNED_INT_24_8_REV : GL_FLOAT , nullptr );
+    glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_MIN_FILTER , GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_MAG_FILTER , GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_COMPARE_MODE , GL_NONE );
+    glBindTexture( GL_TEXTURE_2D , static_cast< GLuint >( texture ));
+
+    GLint renderbuffer = 0;
+    glGetIntegerv( GL_RENDERBUFFER_BINDING , &renderbuffer );
+    glBindRenderbuffer( GL_RENDERBUFFER , _reducedDepth );
+    glRenderbufferStorage( GL_RENDERBUFFER , GL_DEPTH_COMPONENT32F ,
+                           ( width + REDUCTION - 1 ) / REDUCTION ,
+                           ( height + REDUCTION - 1 ) / REDUCTION );
+    glBindRenderbuffer( GL_RENDERBUFFER , static_cast< GLuint >( renderbuffer ));
+
+    // Depth only framebuffers, without color buffers to draw or read
+    GLint drawFramebuffer = 0 , readFramebuffer = 0;
+    glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING , &drawFramebuffer );
+    glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING , &readFramebuffer );
+    glBindFramebuffer( GL_FRAMEBUFFER , _resolveFramebuffer );
+    glFramebufferTexture2D( GL_FRAMEBUFFER ,
+                            stencil ? GL_DEPTH_STENCIL_ATTACHMENT :
+                                      GL_DEPTH_ATTACHMENT ,
+                            GL_TEXTURE_2D , _resolveTexture , 0 );
+    glDrawBuffer( GL_NONE );
+    glReadBuffer( GL_NONE );
+    bool complete =
+      glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer( GL_FRAMEBUFFER , _reducedFramebuffer );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER , GL_DEPTH_ATTACHMENT ,
+                               GL_RENDERBUFFER , _reducedDepth );
+    glDrawBuffer( GL_NONE );
+    glReadBuffer( GL_NONE );
+    complete = complete &&
+      glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer( GL_READ_FRAMEBUFFER ,
+                       static_cast< GLuint >( readFramebuffer ));
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER ,
+                       static_cast< GLuint >( drawFramebuffer ));
+
+    if ( !complete )
+    {
+      std::cerr << "Depth readback framebuffer incomplete" << std::endl;
+      release( );
+      _failed = true;
+      return false;
+    }
+
+    _width = width;
+    _height = height;
+    return true;
+  }
+}
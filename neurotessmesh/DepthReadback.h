@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_DEPTHREADBACK_H_
+#define NEUROTESSMESH_DEPTHREADBACK_H_
+
+// Eigen
+#include <Eigen/Dense>
+
+namespace neurotessmesh
+{
+  class OcclusionCuller;
+
+  /** \class DepthReadback
+   * \brief Asynchronous read back of a reduced depth buffer.
+   *
+   * The depth of the current framebuffer is resolved into a single sample
+   * texture, so multisampled framebuffers are supported, and reduced on the
+   * GPU keeping the farthest depth of each block of texels. The reduced
+   * buffer is copied into a pixel buffer and mapped in a later frame, so
+   * reading it never stalls the pipeline. Requires a current OpenGL
+   * context.
+   *
+   */
+  class DepthReadback
+  {
+  public:
+    DepthReadback( );
+
+    /** \brief Starts reading the depth of the current framebuffer viewport.
+     * \param[in] viewProjection Projection matrix multiplied by the view
+     * matrix used to render the depth.
+     * \returns false if the depth can't be read in the current context.
+     *
+     */
+    bool read( const Eigen::Matrix4f& viewProjection );
+
+    /** \brief Gives the newest finished read to the culler. The reads not
+     * finished yet are kept for the next frames.
+     * \param[out] culler Culler updated with the read depth.
+     * \returns true if the culler was updated.
+     *
+     */
+    bool collect( OcclusionCuller& culler );
+
+    /** \brief Releases the GL resources. Requires the context where they
+     * were created to be current.
+     *
+     */
+    void release( );
+
+  private:
+    bool initialize( );
+
+    bool resize( int width , int height );
+
+    //! Pixel buffer with a read in flight
+    struct Read
+    {
+      unsigned int buffer;
+      unsigned int size;
+      void* fence;
+      unsigned int width;
+      unsigned int height;
+      //! Unaligned, the readback is a member of heap allocated classes
+      Eigen::Matrix< float , 4 , 4 , Eigen::DontAlign > viewProjection;
+    };
+
+    //! Reads in flight, one more than the frames of latency
+    static constexpr unsigned int READS = 2;
+
+    unsigned int _program;
+    unsigned int _vertexArray;
+    int _sourceSizeLocation;
+    unsigned int _resolveFramebuffer;
+    unsigned int _resolveTexture;
+    unsigned int _reducedFramebuffer;
+    unsigned int _reducedDepth;
+    int _width;
+    int _height;
+    unsigned int _depthFormat;
+    bool _failed;
+
+    Read _reads[ READS ];
+    unsigned int _next;
+  };
+}
+
+#endif /* NEUROTESSMESH_DEPTHREADBACK_H_ */
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Project
+#include "FrameBenchmark.h"
+#include "CameraPathRenderer.h"
+#include "Scene.h"
+
+// Qt
+#include <QFile>
+#include <QJsonDocument>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLTimerQuery>
+
+// C++
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+// ReTo
+#include <reto/reto.h>
+
+namespace
+{
+  //! Frames rendered before measuring, to compile shaders and warm caches
+  constexpr int WARMUP_FRAMES = 5;
+
+  //! Results that must match the baseline for the times to be comparable
+  const char* const CONFIGURATION[ ] = { "renderer" , "width" , "height" ,
+                                         "samples" };
+
+  //! Statistics compared to the baseline
+  const char* const COMPARED_STATISTICS[ ] = { "median" , "p95" };
+
+  /** \brief Returns the linearly interpolated percentile of sorted times.
+   *
+   */
+  double percentile( const std::vector< double >& sorted , double p )
+  {
+    const double rank = p * ( sorted.size( ) - 1 );
+    const auto lower = static_cast< size_t >( std::floor( rank ));
+    const auto upper = std::min( lower + 1 , sorted.size( ) - 1 );
+    return sorted[ lower ] + ( rank - lower ) * ( sorted[ upper ] - sorted[ lower ]);
+  }
+}
+
+namespace neurotessmesh
+{
+  FrameBenchmark::FrameBenchmark( OpenGLWidget* widget ,
+                                  std::shared_ptr< Scene > scene ,
+                                  const Options& options )
+    : m_widget{ widget }
+    , m_scene{ std::move( scene ) }
+    , m_options{ options }
+  { }
+
+  QString FrameBenchmark::run( bool& regression )
+  {
+    regression = false;
+
+    std::vector< CameraPosition > positions;
+    const auto error = CameraPathRenderer::readPositions(
+      m_options.positionsFile , positions );
+    if ( !error.isEmpty( ))
+      return error;
+
+    if ( m_options.fps <= 0.0 || m_options.secondsPerPosition < 0.0 ||
+         m_options.size.isEmpty( ) || m_options.tolerance < 0.0 )
+      return QObject::tr( "Invalid frame rate, duration, frame size or "
+                          "tolerance." );
+
+    m_widget->makeCurrent( );
+
+    // Same samples as the widget, so the cost matches the interactive one.
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment( QOpenGLFramebufferObject::CombinedDepthStencil );
+    format.setSamples( std::max( 0 , m_widget->format( ).samples( )));
+    QOpenGLFramebufferObject fbo( m_options.size , format );
+    if ( !fbo.isValid( ))
+      return QObject::tr( "Unable to create the benchmark framebuffer." );
+
+    QOpenGLTimerQuery timer;
+    const bool timerQueries = timer.create( );
+
+    reto::CameraAnimation animation( reto::CameraAnimation::LINEAR ,
+                                     reto::CameraAnimation::LINEAR ,
+                                     reto::CameraAnimation::LINEAR );
+    for ( size_t i = 0; i < positions.size( ); ++i )
+    {
+      const auto& p = positions[ i ];
+      animation.addKeyCamera( new reto::KeyCamera(
+        static_cast< float >( i * m_options.secondsPerPosition ) ,
+        p.position , p.rotation , p.radius ));
+    }
+
+    const double duration =
+      ( positions.size( ) - 1 ) * m_options.secondsPerPosition;
+    const int frames = static_cast< int >(
+      std::round( duration * m_options.fps )) + 1;
+
+    auto camera = m_widget->getCamera( );
+    if ( camera->isAniming( ))
+      camera->stopAnim( );
+    camera->windowSize( m_options.size.width( ) , m_options.size.height( ));
+
+    fbo.bind( );
+    glViewport( 0 , 0 , m_options.size.width( ) , m_options.size.height( ));
+
+    using Clock = std::chrono::steady_clock;
+    auto milliseconds = []( Clock::duration elapsed )
+    {
+      return std::chrono::duration< double , std::milli >( elapsed ).count( );
+    };
+
+    std::vector< double > cpuTimes , gpuTimes , frameTimes;
+    for ( int frame = -WARMUP_FRAMES; frame < frames; ++frame )
+    {
+      const double time = std::min( duration ,
+                                    std::max( 0 , frame ) / m_options.fps );
+      camera->startAnim( &animation );
+      camera->anim( static_cast< float >( time ));
+
+      // The meshes of the view are generated before measuring, otherwise
+      // lazy or budgeted generation is timed instead of the rendering.
+      do
+        m_scene->update( );
+      while ( m_scene->meshesPending( ));
+
+      // Frames start with an idle GPU so they are measured one at a time.
+      glFinish( );
+      const auto start = Clock::now( );
+      if ( timerQueries )
+        timer.begin( );
+
+      glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+      m_scene->render( );
+
+      if ( timerQueries )
+        timer.end( );
+      const auto submitted = Clock::now( );
+      glFinish( );
+      const auto finished = Clock::now( );
+
+      if ( frame < 0 )
+      {
+        if ( timerQueries )
+          timer.waitForResult( );
+        continue;
+      }
+
+      cpuTimes.push_back( milliseconds( submitted - start ));
+      frameTimes.push_back( milliseconds( finished - start ));
+      if ( timerQueries )
+        gpuTimes.push_back( timer.waitForResult( ) * 1e-6 );
+    }
+
+    if ( camera->isAniming( ))
+      camera->stopAnim( );
+    fbo.release( );
+    camera->windowSize( m_widget->width( ) , m_widget->height( ));
+
+    QJsonObject results;
+    results.insert( "renderer" , QString( reinterpret_cast< const char* >(
+      glGetString( GL_RENDERER ))));
+    results.insert( "version" , QString( reinterpret_cast< const char* >(
+      glGetString( GL_VERSION ))));
+    results.insert( "width" , m_options.size.width( ));
+    results.insert( "height" , m_options.size.height( ));
+    results.insert( "samples" , fbo.format( ).samples( ));
+    results.insert( "frames" , frames );
+    results.insert( "cpu_ms" , statistics( cpuTimes ));
+    if ( timerQueries )
+      results.insert( "gpu_ms" , statistics( gpuTimes ));
+    results.insert( "frame_ms" , statistics( frameTimes ));
+
+    const auto json = QJsonDocument( results ).toJson( );
+    if ( m_options.output.isEmpty( ))
+    {
+      std::cout << json.toStdString( ) << std::flush;
+    }
+    else
+    {
+      QFile file{ m_options.output };
+      if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) ||
+           file.write( json ) != json.size( ))
+        return QObject::tr( "Unable to write %1" ).arg( m_options.output );
+    }
+
+    if ( m_options.baseline.isEmpty( ))
+      return QString( );
+
+    return compare( results , regression );
+  }
+
+  QJsonObject FrameBenchmark::statistics( std::vector< double > times )
+  {
+    QJsonObject result;
+    if ( times.empty( ))
+      return result;
+
+    std::sort( times.begin( ) , times.end( ));
+    result.insert( "min" , times.front( ));
+    result.insert( "median" , percentile( times , 0.5 ));
+    result.insert( "p95" , percentile( times , 0.95 ));
+    result.insert( "p99" , percentile( times , 0.99 ));
+    return result;
+  }
+
+  QString FrameBenchmark::compare( const QJsonObject& results ,
+                                   bool& regression ) const
+  {
+    QFile file{ m_options.baseline };
+    if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ))
+      return QObject::tr( "Unable to open: %1" ).arg( m_options.baseline );
+
+    QJsonParseError parserError;
+    const auto jsonDoc = QJsonDocument::fromJson( file.readAll( ) ,
+                                                  &parserError );
+    if ( jsonDoc.isNull( ) || !jsonDoc.isObject( ))
+      return QObject::tr( "Error parsing %1: %2" ).arg( m_options.baseline )
+        .arg( parserError.errorString( ));
+
+    // Times from another GPU, driver or frame setup are not comparable
+    const auto baseline = jsonDoc.object( );
+    for ( const auto key: CONFIGURATION )
+    {
+      if ( baseline.contains( key ) &&
+           baseline.value( key ) != results.value( key ))
+        return QObject::tr( "The baseline %1 '%2' differs from the current "
+                            "'%3'." ).arg( key )
+          .arg( baseline.value( key ).toVariant( ).toString( ))
+          .arg( results.value( key ).toVariant( ).toString( ));
+    }
+
+    // Times missing in either file, as GPU times without timer queries,
+    // are not compared.
+    for ( const auto key: { "cpu_ms" , "gpu_ms" , "frame_ms" })
+    {
+      const auto current = results.value( key ).toObject( );
+      const auto reference = baseline.value( key ).toObject( );
+      for ( const auto statistic: COMPARED_STATISTICS )
+      {
+        if ( !current.contains( statistic ) || !reference.contains( statistic ))
+          continue;
+
+        const double value = current.value( statistic ).toDouble( );
+        const double limit =
+          reference.value( statistic ).toDouble( ) * ( 1.0 + m_options.tolerance );
+        if ( value > limit )
+        {
+          std::cerr << "Regression: " << key << " " << statistic << " "
+                    << value << " ms, baseline limit " << limit << " ms"
+                    << std::endl;
+          regression = true;
+        }
+      }
+    }
+
+    return QString( );
+  }
+}
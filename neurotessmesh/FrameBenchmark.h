@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_FRAMEBENCHMARK_H_
+#define NEUROTESSMESH_FRAMEBENCHMARK_H_
+
+// Project
+#include "OpenGLWidget.h"
+
+// Qt
+#include <QJsonObject>
+#include <QSize>
+#include <QString>
+
+// C++
+#include <memory>
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class FrameBenchmark
+   * \brief Measures the frame times along a path of camera positions.
+   *
+   * The camera positions file and its sampling are the ones of the
+   * CameraPathRenderer. Every frame is rendered offscreen at a fixed size,
+   * once its visible meshes are generated, and waited for, measuring the CPU
+   * time spent submitting it, the GPU time with a timer query and the whole
+   * frame time. The min, median, 95th and 99th percentiles are written as
+   * JSON and compared to a baseline with the same format, usually the
+   * output of a previous run with the same renderer and frame size.
+   *
+   */
+  class FrameBenchmark
+  {
+  public:
+    struct Options
+    {
+      QString positionsFile;          /** camera positions JSON file.      */
+      QString output;                 /** results file, empty for stdout.  */
+      QString baseline;               /** baseline results, empty if none. */
+      double tolerance = 0.1;         /** allowed slowdown over baseline.  */
+      QSize size{ 1920 , 1080 };      /** frame size in pixels.            */
+      double fps = 30.0;              /** path frames per second.          */
+      double secondsPerPosition = 2.0; /** time between camera positions.  */
+    };
+
+    /** \brief FrameBenchmark class constructor.
+     * \param[in] widget Widget with the camera and the OpenGL context.
+     * \param[in] scene Scene to render.
+     * \param[in] options Benchmark options.
+     *
+     */
+    FrameBenchmark( OpenGLWidget* widget , std::shared_ptr< Scene > scene ,
+                    const Options& options );
+
+    /** \brief Renders the camera path, writes the results and compares
+     * them to the baseline.
+     * \param[out] regression true if the median or 95th percentile of any
+     * time is slower than the baseline beyond the tolerance.
+     * \returns Error description or empty if none.
+     *
+     */
+    QString run( bool& regression );
+
+  private:
+    /** \brief Returns the min, median, 95th and 99th percentiles of the
+     * given times.
+     * \param[in] times Frame times in milliseconds.
+     *
+     */
+    static QJsonObject statistics( std::vector< double > times );
+
+    /** \brief Compares the results to the baseline file.
+     * \param[in] results Benchmark results.
+     * \param[out] regression true if the results are slower.
+     * \returns Error description or empty if none, a baseline with another
+     * renderer, size or samples is an error.
+     *
+     */
+    QString compare( const QJsonObject& results , bool& regression ) const;
+
+    OpenGLWidget* m_widget;                    /** rendering widget.      */
+    std::shared_ptr< Scene > m_scene;          /** benchmarked scene.     */
+    const Options m_options;                   /** benchmark options.     */
+  };
+}
+
+#endif /* NEUROTESSMESH_FRAMEBENCHMARK_H_ */
@@ -21,6 +21,7 @@
  */
 
 #include "LoaderThread.h"
+#include "DataSetSnapshot.h"
 
 // NSOL
 #include <memory>
@@ -44,9 +45,98 @@
 
 // C++
 #include <memory>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
 
 using namespace neurotessmesh;
 
+namespace
+{
+  typedef std::vector< uint32_t > MorphologySignature;
+
+  /** \brief Returns a sequence that identifies the morphology geometry: the
+   * soma nodes and the sections of each neurite in preorder, with the exact
+   * bits of the node positions and radii.
+   * \param[in] morphology Neuron morphology.
+   *
+   */
+  MorphologySignature morphologySignature(
+    const nsol::NeuronMorphologyPtr morphology )
+  {
+    MorphologySignature signature;
+
+    auto addFloat = [ &signature ]( const float value )
+    {
+      uint32_t bits;
+      std::memcpy( &bits , &value , sizeof( bits ));
+      signature.push_back( bits );
+    };
+
+    auto addNodes = [ &signature , &addFloat ]( const nsol::Nodes& nodes )
+    {
+      signature.push_back( static_cast< uint32_t >( nodes.size( )));
+      for ( const auto node: nodes )
+      {
+        addFloat( node->point( ).x( ));
+        addFloat( node->point( ).y( ));
+        addFloat( node->point( ).z( ));
+        addFloat( node->radius( ));
+      }
+    };
+
+    if ( morphology->soma( ))
+      addNodes( morphology->soma( )->nodes( ));
+    else
+      signature.push_back( 0 );
+
+    signature.push_back( static_cast< uint32_t >(
+                           morphology->neurites( ).size( )));
+    for ( const auto neurite: morphology->neurites( ))
+    {
+      signature.push_back( static_cast< uint32_t >( neurite->neuriteType( )));
+
+      std::vector< nsol::NeuronMorphologySectionPtr > stack;
+      if ( neurite->firstSection( ))
+        stack.push_back( neurite->firstSection( ));
+
+      while ( !stack.empty( ))
+      {
+        const auto section = stack.back( );
+        stack.pop_back( );
+
+        addNodes( section->nodes( ));
+        signature.push_back( static_cast< uint32_t >(
+                               section->children( ).size( )));
+        for ( const auto child: section->children( ))
+        {
+          const auto childSection =
+            dynamic_cast< nsol::NeuronMorphologySectionPtr >( child );
+          if ( childSection )
+            stack.push_back( childSection );
+        }
+      }
+    }
+
+    return signature;
+  }
+
+  /** \brief FNV-1a hash of the morphology signature.
+   * \param[in] signature Morphology signature.
+   *
+   */
+  uint64_t signatureHash( const MorphologySignature& signature )
+  {
+    uint64_t hash = 14695981039346656037ull;
+    for ( const auto value: signature )
+    {
+      hash ^= value;
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+}
+
 LoaderThread::LoaderThread( const std::string& arg1 , const std::string& arg2 ,
                             const LoaderThread::DataFileType type )
   : QThread( )
@@ -55,6 +145,7 @@ LoaderThread::LoaderThread( const std::string& arg1 , const std::string& arg2 ,
   , m_type{ type }
   , m_dataset{ nullptr }
   , m_player{ nullptr }
+  , m_simplified{ false }
 {
 }
 
@@ -94,6 +185,9 @@ void LoaderThread::run( )
           nsol::MiniColumn ,
           nsol::Column >( );
 
+        emit progress( tr( "Sharing Morphologies" ) , 75 );
+        deduplicateMorphologies( );
+
 //        emit progress( tr( "Loading Spikes" ) , 75 );
 #ifdef NEUROTESSMESH_USE_SIMIL
 //        { // load the spikes data with SimIL, only for blueconfig.
@@ -133,6 +227,9 @@ void LoaderThread::run( )
           nsol::Soma ,
           nsol::NeuronMorphology ,
           nsol::Neuron >( m_fileName );
+
+        emit progress( tr( "Sharing Morphologies" ) , 75 );
+        deduplicateMorphologies( );
         break;
 
       case DataFileType::HDF5:
@@ -141,6 +238,11 @@ void LoaderThread::run( )
 #endif
         break;
 
+      case DataFileType::Snapshot:
+        emit progress( tr( "Loading Snapshot" ) , 50 );
+        m_simplified = DataSetSnapshot::load( m_fileName , m_dataset );
+        break;
+
       default:
         throw std::runtime_error( "Data file type not supported" );
     }
@@ -155,6 +257,51 @@ void LoaderThread::run( )
   }
 }
 
+void LoaderThread::deduplicateMorphologies( )
+{
+  // Morphologies are only compared when their signature hashes match.
+  // Duplicates stay owned by the dataset, but no neuron references them, so
+  // meshes are only generated for the unique ones.
+  std::unordered_map< uint64_t ,
+    std::vector< std::pair< MorphologySignature , nsol::NeuronMorphologyPtr >>>
+    uniqueMorphologies;
+  std::unordered_map< nsol::NeuronMorphologyPtr , nsol::NeuronMorphologyPtr >
+    replacements;
+
+  for ( const auto& neuron: m_dataset->neurons( ))
+  {
+    const auto morphology = neuron.second->morphology( );
+    if ( !morphology ) continue;
+
+    const auto replacement = replacements.find( morphology );
+    if ( replacement == replacements.end( ))
+    {
+      auto signature = morphologySignature( morphology );
+      auto& bucket = uniqueMorphologies[ signatureHash( signature ) ];
+
+      nsol::NeuronMorphologyPtr shared = morphology;
+      for ( const auto& candidate: bucket )
+      {
+        if ( candidate.first == signature )
+        {
+          shared = candidate.second;
+          break;
+        }
+      }
+
+      if ( shared == morphology )
+        bucket.emplace_back( std::move( signature ) , morphology );
+
+      replacements.emplace( morphology , shared );
+      neuron.second->morphology( shared );
+    }
+    else
+    {
+      neuron.second->morphology( replacement->second );
+    }
+  }
+}
+
 #ifdef NEUROTESSMESH_USE_SIMIL
 
 uint8_t LoaderThread::getTypeFromLoaderType( const NeuronType& type )
@@ -56,7 +56,7 @@ namespace neurotessmesh
   public:
     enum class DataFileType
     {
-      BlueConfig , SWC , NsolScene , HDF5
+      BlueConfig , SWC , NsolScene , HDF5 , Snapshot
     };
 
     /** \brief LoaderThread class constructor.
@@ -100,6 +100,12 @@ namespace neurotessmesh
     std::string filename() const
     { return m_fileName; }
 
+    /** \brief Returns true if the loaded morphologies are already simplified.
+     *
+     */
+    bool simplifiedMorphologies( ) const
+    { return m_simplified; }
+
   signals:
 
     void progress( const QString& text , const unsigned int value );
@@ -111,12 +117,19 @@ namespace neurotessmesh
 
     nsol::DataSet* m_dataset; /** nsol dataset with data.      */
     simil::SpikesPlayer* m_player;  /** spikes data or null if none. */
+    bool m_simplified;              /** true if morphologies are simplified. */
 
     QString m_errors;
 
     uint8_t getTypeFromLoaderType( const NeuronType& type );
 
     void loadH5Morphology( );
+
+    /** \brief Makes the neurons with geometrically identical morphologies
+     * share a single morphology instance.
+     *
+     */
+    void deduplicateMorphologies( );
   };
 
   class LoadingDialog
@@ -11,6 +11,7 @@
 #include "MainWindow.h"
 #include "LoaderThread.h"
 #include "SaveScreenshotDialog.h"
+#include "DataSetSnapshot.h"
 #include <neurotessmesh/version.h>
 #include <nsol/nsol.h>
 #include <neurotessmesh/Scene.h>
@@ -48,6 +49,7 @@
 #include <QScreen>
 #include <QWindow>
 #include <QShortcut>
+#include <QApplication>
 
 constexpr const char *POSITION_KEY = "positionData";
 
@@ -59,6 +61,9 @@ MainWindow::MainWindow(QWidget *parent_, bool updateOnIdle_)
 , _scene(nullptr)
 , _recorder(nullptr)
 , m_dataLoader{nullptr}
+, _meshRegenerator{new neurotessmesh::MeshRegenerationThread(this)}
+, _meshExporter{nullptr}
+, _meshExportDialog{nullptr}
 {
   _ui->setupUi(this);
   auto layout = new QVBoxLayout();
@@ -119,6 +124,7 @@ MainWindow::MainWindow(QWidget *parent_, bool updateOnIdle_)
 
 MainWindow::~MainWindow()
 {
+  _meshRegenerator->cancel();
   delete _ui;
 }
 
@@ -155,9 +161,21 @@ void MainWindow::init(const std::string &zeqSession_)
   connect(_ui->actionOpenHDF5File, SIGNAL(triggered()),
           this, SLOT(openHDF5FileThroughDialog()));
 
+  connect(_ui->actionOpenSnapshot, SIGNAL(triggered()),
+          this, SLOT(openSnapshotThroughDialog()));
+
+  connect(_ui->actionSaveSnapshot, SIGNAL(triggered()),
+          this, SLOT(saveSnapshot()));
+
+  connect(_ui->actionExportMeshes, SIGNAL(triggered()),
+          this, SLOT(exportMeshes()));
+
   connect(_radiusSlider, SIGNAL(valueChanged(int)),
           this, SLOT(onActionGenerate(int)));
 
+  connect(_meshRegenerator, SIGNAL(meshReady()),
+          this, SLOT(onEditMeshReady()), Qt::QueuedConnection);
+
   connect(_extractButton, SIGNAL(clicked()),
           _openGLWidget, SLOT(extractEditNeuronMesh()));
 
@@ -200,6 +218,12 @@ void MainWindow::init(const std::string &zeqSession_)
   connect(_backGroundColor, SIGNAL(colorChanged(QColor)),
           _openGLWidget, SLOT(changeClearColor(QColor)));
 
+  connect(_openGLWidget, SIGNAL(neuronsPicked()),
+          this, SLOT(onNeuronsPicked()));
+
+  connect(_openGLWidget, SIGNAL(neuronHovered(int)),
+          this, SLOT(onNeuronHovered(int)));
+
   connect(_ui->actionTake_screenshot, SIGNAL(triggered()),
           this, SLOT(saveScreenshot()));
 
@@ -238,69 +262,42 @@ void MainWindow::openHDF5File(const std::string &fileName)
            neurotessmesh::LoaderThread::DataFileType::HDF5);
 }
 
+void MainWindow::openSnapshot(const std::string &fileName)
+{
+  loadData(fileName, std::string(),
+           neurotessmesh::LoaderThread::DataFileType::Snapshot);
+}
+
 std::set<int> MainWindow::updateNeuronList()
 {
   std::set<int> usedColoringValues;
   if (!_scene)
     return usedColoringValues;
 
-  QApplication::setOverrideCursor(Qt::WaitCursor);
-
-  const auto currentIdx = _neuronList->currentRow();
-  _neuronList->clear();
-
-  for (const auto &n : _scene->neurons())
+  const auto coloring = _renderColoring->currentIndex();
+  if (coloring != 0) // No value returned in selection coloring mode.
   {
-    const auto type = n.second->morphologicalType();
-    const auto function = n.second->functionalType();
-    const auto layer = n.second->layer();
-    const auto id = n.first;
-
-    switch (_renderColoring->currentIndex())
+    for (const auto &n : _scene->neurons())
     {
-    case 1:
-      usedColoringValues.insert(static_cast<int>(type));
-      break;
-    case 2:
-      usedColoringValues.insert(layer);
-      break;
-    case 3:
-      usedColoringValues.insert(static_cast<int>(function));
-      break;
-    case 0: // No value returned in selection coloring mode.
-      /** pass-through **/
-    default:
-      break;
-    }
-
-    const auto color = _scene->neuronColor(id);
-    const auto qcolor = QColor::fromRgbF(color[0], color[1], color[2]);
-    auto itemText = QString::fromStdString(nsol::Neuron::typeToString(type));
-
-    if (_neuronAdditionalText->isChecked() && (function + layer > 0))
-    {
-      QString layerText, functionText, separator;
-      if (function > 0)
-        functionText += QString::fromStdString(nsol::Neuron::functionToString(function));
-      if (layer > 0)
-        layerText += QString("layer ") + QString::number(static_cast<unsigned int>(layer));
-      if (function > 0 && layer > 0)
-        separator = ", ";
-
-      itemText += QString(" (%1%2%3)").arg(functionText).arg(separator).arg(layerText);
+      switch (coloring)
+      {
+      case 1:
+        usedColoringValues.insert(static_cast<int>(n.second->morphologicalType()));
+        break;
+      case 2:
+        usedColoringValues.insert(n.second->layer());
+        break;
+      case 3:
+        usedColoringValues.insert(static_cast<int>(n.second->functionalType()));
+        break;
+      default:
+        break;
+      }
     }
-
-    auto item = new NeuronListItem(id, itemText, qcolor);
-    item->setData(TEXT_ROLE, static_cast<int>(type));
-    item->setData(ID_ROLE, id);
-    item->setData(COLOR_ROLE, qcolor);
-    _neuronList->addItem(item);
   }
 
-  if (currentIdx != -1)
-    _neuronList->setCurrentRow(currentIdx);
-
-  QApplication::restoreOverrideCursor();
+  _neuronListModel->showAdditionalInformation(_neuronAdditionalText->isChecked());
+  _neuronListModel->colorsChanged();
 
   return usedColoringValues;
 }
@@ -385,6 +382,250 @@ void MainWindow::openHDF5FileThroughDialog()
   }
 }
 
+void MainWindow::openSnapshotThroughDialog()
+{
+  QString path = QFileDialog::getOpenFileName(
+      this, tr("Open Snapshot"), _lastOpenedFileName,
+      tr("Snapshot ( *.%1);; All files (*)").arg(neurotessmesh::DataSetSnapshot::EXTENSION),
+      nullptr, QFileDialog::DontUseNativeDialog);
+
+  if (path != QString(""))
+  {
+    std::string fileName = path.toStdString();
+    openSnapshot(fileName);
+  }
+}
+
+void MainWindow::exportMeshes()
+{
+  if (!_scene || _meshExporter)
+    return;
+
+  const QString title = tr("Export meshes");
+
+  const auto &selected = _scene->selectedIndices();
+  QStringList sources;
+  if (!selected.empty())
+    sources << tr("Selected neurons (%1)").arg(selected.size());
+  sources << tr("All neurons (%1)").arg(_scene->neurons().size());
+
+  bool ok = false;
+  const auto source = QInputDialog::getItem(this, title, tr("Neurons to export:"),
+                                            sources, 0, false, &ok);
+  if (!ok)
+    return;
+
+  const QStringList modes{tr("One file per neuron"), tr("Single file in world coordinates")};
+  const auto modeText = QInputDialog::getItem(this, title, tr("Output:"), modes, 0, false, &ok);
+  if (!ok)
+    return;
+
+  const QStringList formats{tr("OBJ"), tr("Binary PLY"), tr("glTF binary (GLB)")};
+  const auto formatText = QInputDialog::getItem(this, title, tr("Format:"), formats, 0, false, &ok);
+  if (!ok)
+    return;
+
+  using Format = neurotessmesh::MeshExporter::Format;
+  const auto format = (formatText == formats.at(1)) ? Format::PLY
+                      : (formatText == formats.at(2)) ? Format::GLB : Format::OBJ;
+  const auto extension = neurotessmesh::MeshExporter::extension(format);
+
+  neurotessmesh::MeshPostProcessor::Options postProcessing;
+  if (format != Format::OBJ)
+  {
+    const QStringList processings{tr("None"), tr("Weld vertices"), tr("Weld vertices and decimate")};
+    const auto processing = QInputDialog::getItem(this, title, tr("Post-processing:"), processings, 0, false, &ok);
+    if (!ok)
+      return;
+
+    postProcessing.weld = (processing != processings.first());
+    if (processing == processings.last())
+    {
+      const int percentage = QInputDialog::getInt(this, title, tr("Triangles to keep (%):"), 25, 1, 100, 1, &ok);
+      if (!ok)
+        return;
+      postProcessing.triangleRatio = percentage / 100.0f;
+    }
+  }
+
+  std::vector<unsigned int> ids;
+  if (source == sources.first() && !selected.empty())
+  {
+    ids.assign(selected.cbegin(), selected.cend());
+  }
+  else
+  {
+    ids.reserve(_scene->neurons().size());
+    for (const auto &neuron : _scene->neurons())
+      ids.push_back(neuron.first);
+  }
+
+  const QString directory = _lastOpenedFileName.isEmpty() ? QDir::homePath() : QFileInfo(_lastOpenedFileName).path();
+  const auto mode = (modeText == modes.first()) ? neurotessmesh::MeshExporter::Mode::PerNeuron
+                                                : neurotessmesh::MeshExporter::Mode::Merged;
+  QString path;
+  if (mode == neurotessmesh::MeshExporter::Mode::PerNeuron)
+  {
+    path = QFileDialog::getExistingDirectory(this, title, directory,
+                                             QFileDialog::ShowDirsOnly | QFileDialog::DontUseNativeDialog);
+  }
+  else
+  {
+    path = QFileDialog::getSaveFileName(this, title, QDir(directory).absoluteFilePath("neurons." + extension),
+                                        tr("%1 (*.%2);; All files (*)").arg(formatText).arg(extension), nullptr,
+                                        QFileDialog::DontUseNativeDialog);
+    if (!path.isEmpty() && !path.endsWith("." + extension, Qt::CaseInsensitive))
+      path += "." + extension;
+  }
+
+  if (path.isEmpty())
+    return;
+
+  _meshExporter = new neurotessmesh::MeshExporter(_scene, _openGLWidget, ids, path, mode, format, this);
+  _meshExporter->setPostProcessing(postProcessing);
+
+  _meshExportDialog = new QProgressDialog(tr("Exporting meshes..."), tr("Cancel"),
+                                          0, _meshExporter->total(), this);
+  _meshExportDialog->setWindowTitle(title);
+  _meshExportDialog->setModal(false);
+  _meshExportDialog->setMinimumDuration(0);
+  _meshExportDialog->setAutoClose(false);
+  _meshExportDialog->setAutoReset(false);
+  _meshExportDialog->setValue(0);
+
+  connect(_meshExporter, SIGNAL(progress(int)),
+          _meshExportDialog, SLOT(setValue(int)));
+  connect(_meshExportDialog, SIGNAL(canceled()),
+          _meshExporter, SLOT(cancel()));
+  connect(_meshExporter, SIGNAL(finished(const QString &)),
+          this, SLOT(onMeshExportFinished(const QString &)));
+
+  _meshExportDialog->show();
+  _meshExporter->start();
+}
+
+void MainWindow::onMeshExportFinished(const QString &error)
+{
+  if (_meshExportDialog)
+  {
+    _meshExportDialog->deleteLater();
+    _meshExportDialog = nullptr;
+  }
+
+  if (_meshExporter)
+  {
+    _meshExporter->deleteLater();
+    _meshExporter = nullptr;
+  }
+
+  if (!error.isEmpty())
+  {
+    QMessageBox msgbox{this};
+    msgbox.setWindowTitle(tr("Export meshes"));
+    msgbox.setIcon(QMessageBox::Icon::Critical);
+    msgbox.setText(tr("Unable to export the meshes."));
+    msgbox.setDetailedText(error);
+    msgbox.setWindowIcon(QIcon(":/icons/rsc/neurotessmesh.png"));
+    msgbox.setStandardButtons(QMessageBox::Ok);
+    msgbox.exec();
+    return;
+  }
+
+  showStatusBarMessage(tr("Mesh export finished."));
+}
+
+void MainWindow::lazyMeshGeneration(bool lazy_)
+{
+  _lazyMeshesCheck->setChecked(lazy_);
+}
+
+void MainWindow::interactiveQuality(float scale_, int samples_)
+{
+  _openGLWidget->interactiveQuality(scale_, samples_);
+}
+
+void MainWindow::onMeshOptionsChanged()
+{
+  if (!_scene)
+    return;
+
+  _openGLWidget->makeCurrent();
+  _scene->meshEvictionPolicy(static_cast<neurotessmesh::MeshResidencyManager::EvictionPolicy>(_meshEvictionPolicy->currentIndex()));
+  _scene->meshMemoryLimit(static_cast<size_t>(_meshMemorySpin->value()) * 1024 * 1024);
+  _scene->lazyMeshGeneration(_lazyMeshesCheck->isChecked());
+  _openGLWidget->update();
+  updateMeshResidencyInfo();
+}
+
+void MainWindow::updateMeshResidencyInfo()
+{
+  if (!_scene)
+  {
+    _meshResidencyLabel->setText(tr("No meshes loaded."));
+    return;
+  }
+
+  const auto &residency = _scene->meshResidency();
+  const double usage = static_cast<double>(residency.usage()) / (1024 * 1024);
+  _meshResidencyLabel->setText(tr("%1 meshes, %2 MB, %3 evictions")
+                                   .arg(residency.residentMeshes())
+                                   .arg(usage, 0, 'f', 1)
+                                   .arg(residency.evictions()));
+}
+
+void MainWindow::saveSnapshot()
+{
+  if (!_scene)
+    return;
+
+  const QString title = tr("Save snapshot");
+  const QString extension = neurotessmesh::DataSetSnapshot::EXTENSION;
+
+  QString suggestion = QString("snapshot.%1").arg(extension);
+  if (!_lastOpenedFileName.isEmpty())
+  {
+    QFileInfo fi(_lastOpenedFileName);
+    suggestion = fi.dir().absoluteFilePath(QString("%1.%2").arg(fi.baseName()).arg(extension));
+  }
+
+  auto fileName = QFileDialog::getSaveFileName(this, title, suggestion,
+                                               tr("Snapshot ( *.%1)").arg(extension),
+                                               nullptr, QFileDialog::DontUseNativeDialog);
+  if (fileName.isEmpty())
+    return;
+
+  if (!fileName.endsWith("." + extension, Qt::CaseInsensitive))
+    fileName += "." + extension;
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+
+  QString error;
+  try
+  {
+    // Meshes may be generated on demand, simplify the rest before storing.
+    _scene->simplifyMorphologies();
+    neurotessmesh::DataSetSnapshot::save(_scene->neurons(), fileName.toStdString(), true);
+  }
+  catch (const std::exception &e)
+  {
+    error = QString::fromLocal8Bit(e.what());
+  }
+
+  QApplication::restoreOverrideCursor();
+
+  if (!error.isEmpty())
+  {
+    QMessageBox msgbox{this};
+    msgbox.setWindowTitle(title);
+    msgbox.setIcon(QMessageBox::Icon::Critical);
+    msgbox.setText(tr("Unable to save snapshot file %1.").arg(fileName));
+    msgbox.setDetailedText(error);
+    msgbox.setWindowIcon(QIcon(":/icons/rsc/neurotessmesh.png"));
+    msgbox.setStandardButtons(QMessageBox::Ok);
+    msgbox.exec();
+  }
+}
+
 void MainWindow::showAbout()
 {
   QMessageBox::about(
@@ -518,12 +759,14 @@ void MainWindow::updatePlayerOptionsDock()
 #endif
 }
 
-void MainWindow::onListClicked(QListWidgetItem *item)
+void MainWindow::onListClicked(const QModelIndex &index)
 {
-  if (!item)
+  if (!index.isValid())
     return;
 
-  const unsigned int id = item->data(ID_ROLE).toUInt();
+  const unsigned int id = index.data(ID_ROLE).toUInt();
+
+  _meshRegenerator->cancel();
 
   _scene->setNeuronToEdit(id);
   _openGLWidget->update();
@@ -532,6 +775,57 @@ void MainWindow::onListClicked(QListWidgetItem *item)
   _somaGroup->show();
 }
 
+void MainWindow::onNeuronFilter()
+{
+  if (!_scene)
+    return;
+
+  const auto query = _neuronFilter->text().trimmed();
+  _neuronFilter->setStyleSheet(QString());
+
+  if (query.isEmpty())
+  {
+    _neuronListModel->clearFilter();
+    return;
+  }
+
+  neurotessmesh::NeuronIndex::Ids ids;
+  try
+  {
+    ids = _neuronIndex.query(query.toStdString());
+  }
+  catch (const std::exception &e)
+  {
+    _neuronFilter->setStyleSheet("QLineEdit { color: red; }");
+    showStatusBarMessage(QString::fromStdString(e.what()));
+    return;
+  }
+
+  _neuronListModel->setFilter(ids);
+  showStatusBarMessage(tr("%1 neurons match the filter.").arg(ids.size()));
+
+  _openGLWidget->makeCurrent();
+  _scene->changeSelectedIndices(ids);
+  _scene->focusOnIndices(ids);
+  _openGLWidget->update();
+  _neuronListModel->colorsChanged();
+}
+
+void MainWindow::onNeuronsPicked()
+{
+  const auto &selection = _scene->selectedIndices();
+  showStatusBarMessage(tr("%1 neurons selected.").arg(selection.size()));
+  _neuronListModel->colorsChanged();
+}
+
+void MainWindow::onNeuronHovered(int id)
+{
+  if (id < 0)
+    _ui->statusbar->clearMessage();
+  else
+    showStatusBarMessage(tr("Neuron %1").arg(id));
+}
+
 void MainWindow::onActionGenerate(int /*value_*/)
 {
   float alphaRadius = static_cast<float>(_radiusSlider->value()) / 100.0f;
@@ -543,9 +837,40 @@ void MainWindow::onActionGenerate(int /*value_*/)
         static_cast<float>(_neuriteSlider->value()) / 100.0f);
   }
 
+  if (!_scene || !_scene->editNeuronMorphology())
+    return;
+
+  // Reuse the mesh if these values have been generated recently.
   _openGLWidget->makeCurrent();
-  _openGLWidget->update();
-  _scene->regenerateEditNeuronMesh(alphaRadius, alphaNeurites);
+  if (_scene->useCachedEditNeuronMesh(alphaRadius, alphaNeurites))
+  {
+    _meshRegenerator->discard();
+    _openGLWidget->update();
+    return;
+  }
+
+  // Generated in background, only the latest slider values are used.
+  _meshRegenerator->request(_scene->editNeuronMorphology(), alphaRadius, alphaNeurites);
+}
+
+void MainWindow::onEditMeshReady()
+{
+  nsol::NeuronMorphologyPtr morphology = nullptr;
+  float alphaRadius = 1.0f;
+  std::vector<float> alphaNeurites;
+  auto mesh = _meshRegenerator->takeMesh(morphology, alphaRadius, alphaNeurites);
+  if (!mesh)
+    return;
+
+  if (!_scene)
+  {
+    delete mesh;
+    return;
+  }
+
+  _openGLWidget->makeCurrent();
+  if (_scene->replaceEditNeuronMesh(morphology, mesh, alphaRadius, alphaNeurites))
+    _openGLWidget->update();
 }
 
 void MainWindow::finishRecording()
@@ -982,9 +1307,21 @@ void MainWindow::_initExtractionDock()
   _neuronsGroup->setLayout(_neuronsLayout);
   _meshDockLayout->addWidget(_neuronsGroup);
 
-  _neuronList = new QListWidget();
-  _neuronList->setSortingEnabled(true);
+  _neuronListModel = new neurotessmesh::NeuronListModel(this);
+  _neuronList = new QListView();
+  _neuronList->setModel(_neuronListModel);
+  _neuronList->setUniformItemSizes(true);
+  _neuronList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  _neuronFilter = new QLineEdit();
+  _neuronFilter->setPlaceholderText(tr("Filter, e.g. 1000-2000 or layer 5 & PYRAMIDAL"));
+  _neuronFilter->setClearButtonEnabled(true);
+  _neuronFilter->setToolTip(
+      "Ids or id ranges (1000-2000), layers (layer 5, layer 2-4), morphological\n"
+      "or functional types (PYRAMIDAL, EXCITATORY). Terms are combined with\n"
+      "'&' (and) and '|' (or). Matching neurons are selected and focused.");
+
   _neuronsLayout->addWidget(new QLabel(QString("Neurons")));
+  _neuronsLayout->addWidget(_neuronFilter);
   _neuronsLayout->addWidget(_neuronList);
 
   // Soma reconstruction group
@@ -1023,8 +1360,11 @@ void MainWindow::_initExtractionDock()
   _extractButton->setEnabled(false);
   _meshDockLayout->addWidget(_extractButton);
 
-  connect(_neuronList, SIGNAL(itemClicked(QListWidgetItem *)),
-          this, SLOT(onListClicked(QListWidgetItem *)));
+  connect(_neuronList, SIGNAL(clicked(const QModelIndex &)),
+          this, SLOT(onListClicked(const QModelIndex &)));
+
+  connect(_neuronFilter, SIGNAL(returnPressed()),
+          this, SLOT(onNeuronFilter()));
 
   connect(_extractMeshDock->toggleViewAction(), SIGNAL(toggled(bool)),
           _ui->actionEditSave, SLOT(setChecked(bool)));
@@ -1100,6 +1440,55 @@ void MainWindow::_initConfigurationDock()
   connect(_radioLinear, SIGNAL(toggled(bool)),
           _distanceSlider, SLOT(setEnabled(bool)));
 
+  auto meshGenerationGroup = new QGroupBox(QString("Mesh generation"));
+  _configDockLayout->addWidget(meshGenerationGroup);
+  auto meshGrid = new QGridLayout;
+  meshGenerationGroup->setLayout(meshGrid);
+
+  _lazyMeshesCheck = new QCheckBox(QString("Generate meshes on demand"));
+  _lazyMeshesCheck->setToolTip(
+      "Generate each neuron mesh the first time it is visible, selected or\n"
+      "edited. A soma placeholder is drawn until then.");
+  meshGrid->addWidget(_lazyMeshesCheck, 0, 0, 1, 2);
+
+  _meshMemorySpin = new QSpinBox();
+  _meshMemorySpin->setRange(0, 65536);
+  _meshMemorySpin->setSingleStep(64);
+  _meshMemorySpin->setSuffix(" MB");
+  _meshMemorySpin->setSpecialValueText(tr("Unlimited"));
+  _meshMemorySpin->setValue(0);
+  _meshMemorySpin->setToolTip(
+      "Maximum GPU memory used by the neuron meshes. When exceeded meshes\n"
+      "are released and regenerated when they are visible again.");
+  meshGrid->addWidget(new QLabel(QString("GPU memory limit")), 1, 0);
+  meshGrid->addWidget(_meshMemorySpin, 1, 1);
+
+  _meshEvictionPolicy = new QComboBox();
+  _meshEvictionPolicy->addItem(QString("Least recently used"));
+  _meshEvictionPolicy->addItem(QString("Farthest from camera"));
+  _meshEvictionPolicy->setToolTip(
+      "Meshes released first when the GPU memory limit is exceeded.");
+  meshGrid->addWidget(new QLabel(QString("Eviction")), 2, 0);
+  meshGrid->addWidget(_meshEvictionPolicy, 2, 1);
+
+  _meshResidencyLabel = new QLabel();
+  meshGrid->addWidget(_meshResidencyLabel, 3, 0, 1, 2);
+
+  _meshResidencyTimer = new QTimer(this);
+  _meshResidencyTimer->setInterval(1000);
+  _meshResidencyTimer->start();
+
+  connect(_lazyMeshesCheck, SIGNAL(toggled(bool)),
+          this, SLOT(onMeshOptionsChanged()));
+  connect(_meshMemorySpin, SIGNAL(valueChanged(int)),
+          this, SLOT(onMeshOptionsChanged()));
+  connect(_meshEvictionPolicy, SIGNAL(currentIndexChanged(int)),
+          this, SLOT(onMeshOptionsChanged()));
+  connect(_meshResidencyTimer, SIGNAL(timeout()),
+          this, SLOT(updateMeshResidencyInfo()));
+
+  updateMeshResidencyInfo();
+
   connect(_configurationDock->toggleViewAction(), SIGNAL(toggled(bool)),
           _ui->actionConfiguration, SLOT(setChecked(bool)));
 
@@ -1168,6 +1557,16 @@ void MainWindow::_initRenderOptionsDock()
   _selectedNeuronRender->addItem(QString("neurites"));
   _selectedNeuronRender->setCurrentIndex(0);
 
+  hLay = new QHBoxLayout();
+  hLay->addWidget(new QLabel(QString("Neuron opacity")));
+  _unselectedOpacity = new QSlider(Qt::Horizontal);
+  _unselectedOpacity->setRange(0, 100);
+  _unselectedOpacity->setValue(100);
+  hLay->addWidget(_unselectedOpacity);
+  vbox->addLayout(hLay);
+  connect(_unselectedOpacity, SIGNAL(valueChanged(int)),
+          this, SLOT(onUnselectedOpacityChanged(int)));
+
   connect(_renderOptionsDock->toggleViewAction(), SIGNAL(toggled(bool)),
           _ui->actionRenderOptions, SLOT(setChecked(bool)));
 
@@ -1204,6 +1603,90 @@ void MainWindow::_initRenderOptionsDock()
 
   onColoringChanged(0);
   coloringGroup->setEnabled(false);
+
+  // Slab position and thickness are relative to the scene bounding box
+  _slabGroup = new QGroupBox(QString("Slab view"));
+  _slabGroup->setCheckable(true);
+  _slabGroup->setChecked(false);
+  roDockLayout->addWidget(_slabGroup);
+  gridbox = new QGridLayout;
+  _slabGroup->setLayout(gridbox);
+
+  _slabAxis = new QComboBox();
+  _slabAxis->addItem("X");
+  _slabAxis->addItem("Y");
+  _slabAxis->addItem("Z");
+  _slabAxis->setCurrentIndex(2);
+  gridbox->addWidget(new QLabel(QString("Axis")), 0, 0);
+  gridbox->addWidget(_slabAxis, 0, 1);
+
+  _slabPosition = new QSlider(Qt::Horizontal);
+  _slabPosition->setRange(0, 1000);
+  _slabPosition->setValue(500);
+  gridbox->addWidget(new QLabel(QString("Position")), 1, 0);
+  gridbox->addWidget(_slabPosition, 1, 1);
+
+  _slabThickness = new QSlider(Qt::Horizontal);
+  _slabThickness->setRange(1, 1000);
+  _slabThickness->setValue(100);
+  gridbox->addWidget(new QLabel(QString("Thickness")), 2, 0);
+  gridbox->addWidget(_slabThickness, 2, 1);
+
+  connect(_slabGroup, SIGNAL(toggled(bool)), this, SLOT(onSlabChanged()));
+  connect(_slabAxis, SIGNAL(currentIndexChanged(int)), this, SLOT(onSlabChanged()));
+  connect(_slabPosition, SIGNAL(valueChanged(int)), this, SLOT(onSlabChanged()));
+  connect(_slabThickness, SIGNAL(valueChanged(int)), this, SLOT(onSlabChanged()));
+
+  _slabGroup->setEnabled(false);
+
+  _occlusionCheck = new QCheckBox(QString("Occlusion culling"));
+  _occlusionCheck->setToolTip(QString("Skips the neurons hidden behind others"));
+  roDockLayout->addWidget(_occlusionCheck);
+  connect(_occlusionCheck, SIGNAL(toggled(bool)),
+          this, SLOT(onOcclusionCullingChanged(bool)));
+  _occlusionCheck->setEnabled(false);
+}
+
+void MainWindow::onUnselectedOpacityChanged(int value)
+{
+  if (!_scene)
+    return;
+
+  _scene->unselectedAlpha(value / 100.0f);
+  _openGLWidget->update();
+}
+
+void MainWindow::onOcclusionCullingChanged(bool enabled)
+{
+  if (!_scene)
+    return;
+
+  _scene->occlusionCulling(enabled);
+  _openGLWidget->update();
+}
+
+void MainWindow::onSlabChanged()
+{
+  if (!_scene)
+    return;
+
+  Eigen::Vector3f minimum, maximum;
+  if (!_slabGroup->isChecked() || !_scene->neuronBounds().extent(minimum, maximum))
+  {
+    _scene->clippingPlanes(neurotessmesh::NeuronPicker::Planes());
+  }
+  else
+  {
+    const auto axis = static_cast<unsigned int>(_slabAxis->currentIndex());
+    const float start = minimum[axis];
+    const float size = maximum[axis] - start;
+    const float center = start + size * _slabPosition->value() / 1000.0f;
+    const float half = 0.5f * size * _slabThickness->value() / 1000.0f;
+
+    _scene->slab(axis, center - half, center + half);
+  }
+
+  _openGLWidget->update();
 }
 
 void MainWindow::onColoringChanged(int index)
@@ -1484,9 +1967,12 @@ void MainWindow::changeNeuronColor(QColor color)
     const auto type = widget->property("type").toInt(&ok);
     if (ok && _scene)
     {
-      _scene->setColor(type, Eigen::Vector3f(color.redF(), color.greenF(), color.blueF()));
+      const Eigen::Vector3f newColor(color.redF(), color.greenF(), color.blueF());
+      _scene->setColor(type, newColor);
+
+      // Only the rows of the changed type need to be repainted.
+      _neuronListModel->colorsChanged(_scene->coloringMode(), type);
     }
-    updateNeuronList();
     _openGLWidget->repaint();
   }
 }
@@ -1522,7 +2008,16 @@ void MainWindow::saveScreenshot()
     if (validFileExtensions.contains(extension))
     {
       if (image.size() != outputSize)
-        image = image.scaled(outputSize.width(), outputSize.height(), Qt::AspectRatioMode::KeepAspectRatio, Qt::TransformationMode::SmoothTransformation);
+      {
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        auto rendered = _openGLWidget->renderImage(outputSize);
+        QApplication::restoreOverrideCursor();
+
+        if (!rendered.isNull())
+          image = rendered.convertToFormat(QImage::Format_RGB32);
+        else
+          image = image.scaled(outputSize.width(), outputSize.height(), Qt::AspectRatioMode::KeepAspectRatio, Qt::TransformationMode::SmoothTransformation);
+      }
 
       auto saved = image.save(fileName, extension.toUtf8(), 100);
 
@@ -1596,6 +2091,13 @@ void MainWindow::onDataLoaded()
   {
     m_dataLoader = nullptr;
 
+    if (_cameraPath || _benchmark)
+    {
+      std::cerr << errors.toStdString() << std::endl;
+      QApplication::exit(1);
+      return;
+    }
+
     QMessageBox msgbox{this};
     msgbox.setWindowTitle(tr("Error loading dataset"));
     msgbox.setIcon(QMessageBox::Icon::Critical);
@@ -1614,17 +2116,33 @@ void MainWindow::onDataLoaded()
     _openGLWidget->makeCurrent();
     _openGLWidget->update();
 
+    _meshRegenerator->cancel();
+    if (_meshExporter)
+      _meshExporter->cancel();
     _scene = std::make_shared<neurotessmesh::Scene>(_openGLWidget->getCamera(), m_dataLoader->getDataset()
 #ifdef NEUROTESSMESH_USE_SIMIL
     , m_dataLoader->getPlayer()
 #endif
+    , m_dataLoader->simplifiedMorphologies()
+    , _lazyMeshesCheck->isChecked()
+    , static_cast<size_t>(_meshMemorySpin->value()) * 1024 * 1024
+    , static_cast<neurotessmesh::MeshResidencyManager::EvictionPolicy>(_meshEvictionPolicy->currentIndex())
     );
     _openGLWidget->setScene(_scene);
+    _neuronListModel->setScene(_scene);
+    _neuronIndex.build(_scene->neurons());
   }
   catch (const std::exception &e)
   {
     m_dataLoader = nullptr;
 
+    if (_cameraPath || _benchmark)
+    {
+      std::cerr << "Unable to load dataset. Geometry error. " << e.what() << std::endl;
+      QApplication::exit(1);
+      return;
+    }
+
     QMessageBox msgbox{this};
     msgbox.setWindowTitle(tr("Error loading dataset"));
     msgbox.setIcon(QMessageBox::Icon::Critical);
@@ -1636,6 +2154,9 @@ void MainWindow::onDataLoaded()
     return;
   }
 
+  _ui->actionSaveSnapshot->setEnabled(true);
+  _ui->actionExportMeshes->setEnabled(true);
+
   _openGLWidget->onLotValueChanged(_lotSlider->value());
   _openGLWidget->onDistanceValueChanged(_distanceSlider->value());
 
@@ -1643,6 +2164,11 @@ void MainWindow::onDataLoaded()
   _openGLWidget->changeNeuronColor(1, QColor(250, 120, 0)); // selected color
   _openGLWidget->changeNeuronColor(0, QColor(0, 120, 250)); // unselected color
   _renderColoring->parentWidget()->setEnabled(true);
+  _slabGroup->setEnabled(true);
+  onSlabChanged();
+  _occlusionCheck->setEnabled(true);
+  onOcclusionCullingChanged(_occlusionCheck->isChecked());
+  onUnselectedOpacityChanged(_unselectedOpacity->value());
   _renderColoring->setCurrentIndex(0);
   onColoringChanged(0);
   updateNeuronList();
@@ -1681,5 +2207,51 @@ void MainWindow::onDataLoaded()
   }
 #endif
 
+  if (_cameraPath)
+    QTimer::singleShot(0, this, SLOT(runCameraPath()));
+  else if (_benchmark)
+    QTimer::singleShot(0, this, SLOT(runBenchmark()));
+
   m_dataLoader = nullptr;
 }
+
+void MainWindow::renderCameraPath(const neurotessmesh::CameraPathRenderer::Options &options_)
+{
+  _cameraPath.reset(new neurotessmesh::CameraPathRenderer::Options(options_));
+}
+
+void MainWindow::runCameraPath()
+{
+  if (!_cameraPath || !_scene)
+    return;
+
+  neurotessmesh::CameraPathRenderer renderer(_openGLWidget, *_cameraPath);
+  _cameraPath.reset();
+
+  const auto error = renderer.render();
+  if (!error.isEmpty())
+    std::cerr << error.toStdString() << std::endl;
+
+  QApplication::exit(error.isEmpty() ? 0 : 1);
+}
+
+void MainWindow::benchmark(const neurotessmesh::FrameBenchmark::Options &options_)
+{
+  _benchmark.reset(new neurotessmesh::FrameBenchmark::Options(options_));
+}
+
+void MainWindow::runBenchmark()
+{
+  if (!_benchmark || !_scene)
+    return;
+
+  neurotessmesh::FrameBenchmark benchmark(_openGLWidget, _scene, *_benchmark);
+  _benchmark.reset();
+
+  bool regression = false;
+  const auto error = benchmark.run(regression);
+  if (!error.isEmpty())
+    std::cerr << error.toStdString() << std::endl;
+
+  QApplication::exit(!error.isEmpty() ? 1 : (regression ? 2 : 0));
+}
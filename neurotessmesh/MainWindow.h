@@ -14,23 +14,30 @@
 #include "OpenGLWidget.h"
 #include "ColorSelectionWidget.h"
 #include "LoaderThread.h"
+#include "NeuronListModel.h"
+#include "NeuronIndex.h"
+#include "MeshRegenerationThread.h"
+#include "MeshExporter.h"
+#include "CameraPathRenderer.h"
+#include "FrameBenchmark.h"
 
 // C++
 #include <set>
 
 // Qt
 #include <QDockWidget>
-#include <QListWidget>
+#include <QListView>
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QComboBox>
 #include <QRadioButton>
 #include <QGroupBox>
 #include <QCheckBox>
-
-constexpr int ID_ROLE = Qt::UserRole +1;
-constexpr int COLOR_ROLE = Qt::UserRole +2;
-constexpr int TEXT_ROLE = Qt::UserRole +3;
+#include <QSpinBox>
+#include <QLabel>
+#include <QTimer>
+#include <QLineEdit>
+#include <QProgressDialog>
 
 namespace Ui
 {
@@ -73,6 +80,36 @@ public:
 
   void openHDF5File( const std::string& fileName );
 
+  void openSnapshot( const std::string& fileName );
+
+  /** \brief Enables or disables the on demand generation of neuron meshes.
+   * \param[in] lazy_ true to generate the meshes when first needed.
+   *
+   */
+  void lazyMeshGeneration( bool lazy_ );
+
+  /** \brief Sets the quality of the frames rendered while the camera moves.
+   * \param[in] scale_ Resolution scale, 1 to always render at full quality.
+   * \param[in] samples_ Multisampling samples, 0 to disable it.
+   *
+   */
+  void interactiveQuality( float scale_ , int samples_ );
+
+  /** \brief Renders the camera path once the dataset is loaded and then
+   * quits the application with 0 on success or 1 on error.
+   * \param[in] options_ Camera path rendering options.
+   *
+   */
+  void renderCameraPath( const neurotessmesh::CameraPathRenderer::Options& options_ );
+
+  /** \brief Measures the frame times along a camera path once the dataset
+   * is loaded and then quits the application with 0 on success, 1 on error
+   * or 2 if slower than the baseline.
+   * \param[in] options_ Benchmark options.
+   *
+   */
+  void benchmark( const neurotessmesh::FrameBenchmark::Options& options_ );
+
 public slots:
 
   /** \brief Updates the neurons list and returns the coloring values used
@@ -91,6 +128,8 @@ public slots:
 
   void openHDF5FileThroughDialog( );
 
+  void openSnapshotThroughDialog( );
+
   void showAbout( );
 
   void openRecorder( );
@@ -103,12 +142,61 @@ public slots:
 
   void updatePlayerOptionsDock( );
 
-  void onListClicked( QListWidgetItem* item );
+  void onListClicked( const QModelIndex& index );
+
+  /** \brief Filters the neuron list with the filter bar query and selects
+   * and focuses the matching neurons.
+   *
+   */
+  void onNeuronFilter( );
+
+  /** \brief Swaps in the edited neuron mesh generated in background.
+   *
+   */
+  void onEditMeshReady( );
 
   void onActionGenerate( int value_ );
 
   void onColoringChanged(int index);
 
+  /** \brief Applies the mesh generation options to the current scene.
+   *
+   */
+  void onMeshOptionsChanged( );
+
+  /** \brief Shows the current GPU memory usage and evictions of the meshes.
+   *
+   */
+  void updateMeshResidencyInfo( );
+
+  /** \brief Refreshes the neuron list after picking neurons in the viewport.
+   *
+   */
+  void onNeuronsPicked( );
+
+  /** \brief Shows the neuron under the cursor in the status bar.
+   * \param[in] id Id of the neuron or -1 if there's none.
+   *
+   */
+  void onNeuronHovered( int id );
+
+  /** \brief Applies the slab view options to the scene.
+   *
+   */
+  void onSlabChanged( );
+
+  /** \brief Enables or disables the occlusion culling of the scene.
+   * \param[in] enabled true to cull the hidden neurons.
+   *
+   */
+  void onOcclusionCullingChanged( bool enabled );
+
+  /** \brief Changes the opacity of the unselected neurons.
+   * \param[in] value Opacity percentage.
+   *
+   */
+  void onUnselectedOpacityChanged( int value );
+
 protected slots:
 
   void finishRecording( );
@@ -155,6 +243,32 @@ protected slots:
    */
   void saveScreenshot();
 
+  /** \brief Saves the loaded dataset to a snapshot file on disk.
+   *
+   */
+  void saveSnapshot();
+
+  /** \brief Exports the meshes of the selected or all the neurons.
+   *
+   */
+  void exportMeshes();
+
+  /** \brief Ends the mesh export and reports any error.
+   * \param[in] error Error description or empty if none.
+   *
+   */
+  void onMeshExportFinished(const QString &error);
+
+  /** \brief Renders the pending camera path and quits.
+   *
+   */
+  void runCameraPath();
+
+  /** \brief Runs the pending frame benchmark and quits.
+   *
+   */
+  void runBenchmark();
+
   /** \brief Puts the application in fullscreen mode
    * 
    */
@@ -203,7 +317,10 @@ private:
   QDockWidget* _renderOptionsDock;
   QDockWidget* _playerDock;
 
-  QListWidget* _neuronList;
+  QListView* _neuronList;
+  neurotessmesh::NeuronListModel* _neuronListModel;
+  neurotessmesh::NeuronIndex _neuronIndex;
+  QLineEdit* _neuronFilter;
   QSlider* _radiusSlider;
   QVBoxLayout* _neuritesLayout;
   std::vector< QSlider* > _neuriteSliders;
@@ -216,91 +333,35 @@ private:
   QRadioButton* _radioHomogeneous;
   QRadioButton* _radioLinear;
 
+  QCheckBox* _lazyMeshesCheck;
+  QSpinBox* _meshMemorySpin;
+  QComboBox* _meshEvictionPolicy;
+  QLabel* _meshResidencyLabel;
+  QTimer* _meshResidencyTimer;
+
   ColorSelectionWidget* _backGroundColor;
   ColorSelectionWidget* _neuronColor;
   ColorSelectionWidget* _selectedNeuronColor;
 
   QComboBox* _neuronRender;
   QComboBox* _selectedNeuronRender;
+  QSlider* _unselectedOpacity;
 
   QComboBox* _renderColoring;
+  QGroupBox* _slabGroup;
+  QComboBox* _slabAxis;
+  QSlider* _slabPosition;
+  QSlider* _slabThickness;
+  QCheckBox* _occlusionCheck;
   QCheckBox* _neuronAdditionalText;
   QGridLayout *_colorLayout;
 
   // Recorder
   Recorder* _recorder;
   std::shared_ptr< neurotessmesh::LoaderThread > m_dataLoader;
+  neurotessmesh::MeshRegenerationThread* _meshRegenerator;
+  neurotessmesh::MeshExporter* _meshExporter;
+  QProgressDialog* _meshExportDialog;
+  std::unique_ptr< neurotessmesh::CameraPathRenderer::Options > _cameraPath;
+  std::unique_ptr< neurotessmesh::FrameBenchmark::Options > _benchmark;
 };
-
-/** \class NeuronListItem
- * \brief List item for the neuron list widget.
- *
- */
-class NeuronListItem
-: public QListWidgetItem
-{
-  public:
-    /** \brief NeuronListItem class constructor.
-     * \param[in] id Id number of the neuron in the dataset.
-     * \param[in] text Text to show in the item.
-     * \param[in] color Background color.
-     *
-     */
-    explicit NeuronListItem(uint32_t id, QString text = QString(), QColor color = QColor())
-    : QListWidgetItem()
-    , m_id{id}
-    , m_text{text}
-    , m_color{color}
-    {}
-
-    virtual QVariant data(int role) const override
-    {
-      switch(role)
-      {
-        case Qt::DisplayRole:
-          return QString::number(m_id) + " " + m_text;
-          break;
-        case Qt::BackgroundColorRole:
-          if(m_color != QColor()) return m_color;
-          break;
-        case Qt::TextColorRole:
-          if(m_color != QColor())
-          { // try to return a color with a lot of contrast with the background
-            const auto a = 1 - ( 0.299 * m_color.redF() + 0.587 * m_color.greenF() + 0.114 * m_color.blueF());
-            return (a <= 0.3) ? QColor(0,0,0) : QColor(255,255,255);
-          }
-          break;
-        case ID_ROLE:
-          return m_id;
-          break;
-        case COLOR_ROLE:
-          return m_color.name();
-          break;
-        case TEXT_ROLE:
-          return m_text;
-          break;
-        default:
-          break;
-      }
-
-      return QListWidgetItem::data(role);
-    }
-
-    /** \brief NeuronListItem class virtual destructor.
-     *
-     */
-    virtual ~NeuronListItem() {};
-
-    /** \brief To sort the items in the list.
-     *
-     */
-    bool operator <(const QListWidgetItem &other) const override
-    {
-      return this->m_id < static_cast<const NeuronListItem&>(other).m_id;
-    }
-
-    uint32_t m_id;  /** neuron id in the dataset. */
-    QString m_text; /** text to show. */
-    QColor m_color; /** background color. */
-};
-
@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Project
+#include "MeshExporter.h"
+#include <neurotessmesh/Scene.h>
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QOpenGLWidget>
+#include <QRunnable>
+
+// C++
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+  const std::string HEADER( "# exported by NeuroTessMesh.\n" );
+
+  /** \brief Runs a function in a thread pool.
+   *
+   */
+  class FunctionRunnable
+    : public QRunnable
+  {
+  public:
+    explicit FunctionRunnable( std::function< void( ) > function )
+      : m_function( std::move( function ))
+    { }
+
+    virtual void run( ) override
+    { m_function( ); }
+
+  private:
+    std::function< void( ) > m_function;
+  };
+
+  /** \brief Formats the mesh as an OBJ object whose vertex indices start
+   * after the given number of previous vertices.
+   * \param[in] mesh Extracted mesh.
+   * \param[in] id Neuron id.
+   * \param[in] offset Number of vertices written before this mesh.
+   *
+   */
+  std::string objChunk( const nlgeometry::MeshPtr mesh , unsigned int id ,
+                        size_t offset )
+  {
+    // Enough digits to read back the same floats
+    std::ostringstream stream;
+    stream << std::setprecision( std::numeric_limits< float >::max_digits10 );
+    stream << "o neuron_" << id << "\n";
+
+    std::unordered_map< nlgeometry::VertexPtr , size_t > indices;
+    indices.reserve( mesh->vertices( ).size( ));
+    for ( const auto vertex: mesh->vertices( ))
+    {
+      const auto& position = vertex->position( );
+      stream << "v " << position.x( ) << " " << position.y( ) << " "
+             << position.z( ) << "\n";
+      indices[ vertex ] = offset + indices.size( ) + 1;
+    }
+
+    auto writeFacets = [ &stream , &indices ]( const nlgeometry::Facets& facets )
+    {
+      for ( const auto facet: facets )
+      {
+        stream << "f";
+        for ( const auto vertex: facet->vertices( ))
+          stream << " " << indices[ vertex ];
+        stream << "\n";
+      }
+    };
+    writeFacets( mesh->triangles( ));
+    writeFacets( mesh->quads( ));
+
+    return stream.str( );
+  }
+}
+
+namespace neurotessmesh
+{
+  QString MeshExporter::extension( const Format format )
+  {
+    switch ( format )
+    {
+      case Format::PLY:
+        return QStringLiteral( "ply" );
+      case Format::GLB:
+        return QStringLiteral( "glb" );
+      case Format::OBJ:
+      default:
+        break;
+    }
+
+    return QStringLiteral( "obj" );
+  }
+
+  MeshExporter::MeshExporter( std::shared_ptr< Scene > scene ,
+                              QOpenGLWidget* widget ,
+                              const std::vector< unsigned int >& ids ,
+                              const QString& path ,
+                              const Mode mode ,
+                              const Format format ,
+                              QObject* parent )
+    : QObject( parent )
+    , m_scene{ scene }
+    , m_widget{ widget }
+    , m_ids{ ids }
+    , m_path{ path }
+    , m_mode{ mode }
+    , m_format{ format }
+    , m_next{ 0 }
+    , m_sequence{ 0 }
+    , m_inFlight{ 0 }
+    , m_written{ 0 }
+    , m_vertexOffset{ 0 }
+    , m_cancelled{ false }
+    , m_finished{ false }
+    , m_nextChunk{ 0 }
+  {
+    m_timer.setInterval( 0 );
+    connect( &m_timer , SIGNAL( timeout( )) , this , SLOT( extractNext( )));
+  }
+
+  MeshExporter::~MeshExporter( )
+  {
+    m_cancelled = true;
+    m_timer.stop( );
+    m_pool.waitForDone( );
+  }
+
+  void MeshExporter::start( )
+  {
+    if ( m_mode == Mode::Merged && m_format == Format::OBJ )
+    {
+      m_mergeFile.open( m_path.toStdString( ) ,
+                        std::ios::out | std::ios::trunc );
+      if ( !m_mergeFile )
+      {
+        m_error = tr( "Unable to open %1 for writing." ).arg( m_path );
+        m_cancelled = true;
+        checkFinished( );
+        return;
+      }
+      m_mergeFile << HEADER;
+    }
+    else if ( m_mode == Mode::Merged )
+    {
+      try
+      {
+        m_mergeWriter.reset( new StreamingMeshWriter(
+          m_path.toStdString( ) , m_format == Format::PLY ?
+          StreamingMeshWriter::PLY : StreamingMeshWriter::GLB , HEADER ));
+      }
+      catch ( const std::exception& e )
+      {
+        m_error = QString::fromStdString( e.what( ));
+        m_cancelled = true;
+        checkFinished( );
+        return;
+      }
+    }
+
+    m_timer.start( );
+  }
+
+  void MeshExporter::cancel( )
+  {
+    m_cancelled = true;
+    m_timer.stop( );
+    checkFinished( );
+  }
+
+  void MeshExporter::extractNext( )
+  {
+    if ( m_cancelled || m_next >= m_ids.size( ))
+    {
+      m_timer.stop( );
+      checkFinished( );
+      return;
+    }
+
+    // Bound the extracted meshes waiting to be written.
+    if ( m_inFlight >= 2 * m_pool.maxThreadCount( ))
+      return;
+
+    const auto id = m_ids[ m_next++ ];
+
+    m_widget->makeCurrent( );
+    auto mesh = m_scene->extractNeuronMesh( id );
+    glUseProgram( 0 );
+
+    if ( !mesh )
+    {
+      ++m_written;
+      emit progress( m_written );
+      return;
+    }
+
+    // Only extracted meshes take a merge sequence, so the merged chunks
+    // have no holes for the neurons skipped above.
+    const auto sequence = m_sequence++;
+
+    ++m_inFlight;
+
+    std::function< void( ) > task;
+    if ( m_mode == Mode::PerNeuron )
+    {
+      const auto fileName = QDir( m_path ).absoluteFilePath(
+        QString( "neuron_%1.%2" ).arg( id ).arg( extension( m_format ))).toStdString( );
+
+      task = [ this , mesh , fileName ]( )
+      {
+        QString error;
+        if ( !m_cancelled )
+        {
+          try
+          {
+            switch ( m_format )
+            {
+              case Format::OBJ:
+                nlgeometry::ObjWriter::writeMesh( mesh , fileName , HEADER );
+                break;
+              case Format::PLY:
+              case Format::GLB:
+              {
+                auto indexed = IndexedMesh::fromMesh( mesh );
+                MeshPostProcessor::process( indexed , m_postProcessing );
+                if ( m_format == Format::PLY )
+                  BinaryMeshWriter::writePLY( indexed , fileName , HEADER );
+                else
+                  BinaryMeshWriter::writeGLB( indexed , fileName );
+                break;
+              }
+            }
+          }
+          catch ( const std::exception& e )
+          {
+            error = QString::fromStdString( e.what( ));
+          }
+        }
+        delete mesh;
+
+        QMetaObject::invokeMethod( this , "onWritten" , Qt::QueuedConnection ,
+                                   Q_ARG( QString , error ));
+      };
+    }
+    else if ( m_format != Format::OBJ )
+    {
+      task = [ this , mesh , sequence ]( )
+      {
+        QString error;
+        if ( !m_cancelled )
+        {
+          auto indexed = IndexedMesh::fromMesh( mesh );
+          MeshPostProcessor::process( indexed , m_postProcessing );
+
+          QMutexLocker lock( &m_mergeMutex );
+          m_meshChunks[ sequence ] = std::move( indexed );
+          try
+          {
+            flushChunks( );
+          }
+          catch ( const std::exception& e )
+          {
+            error = QString::fromStdString( e.what( ));
+          }
+        }
+        delete mesh;
+
+        QMetaObject::invokeMethod( this , "onWritten" , Qt::QueuedConnection ,
+                                   Q_ARG( QString , error ));
+      };
+    }
+    else
+    {
+      const auto offset = m_vertexOffset;
+      m_vertexOffset += mesh->vertices( ).size( );
+
+      task = [ this , mesh , id , offset , sequence ]( )
+      {
+        QString error;
+        if ( !m_cancelled )
+        {
+          auto chunk = objChunk( mesh , id , offset );
+
+          QMutexLocker lock( &m_mergeMutex );
+          m_chunks[ sequence ] = std::move( chunk );
+          flushChunks( );
+          if ( !m_mergeFile )
+            error = tr( "Error writing %1." ).arg( m_path );
+        }
+        delete mesh;
+
+        QMetaObject::invokeMethod( this , "onWritten" , Qt::QueuedConnection ,
+                                   Q_ARG( QString , error ));
+      };
+    }
+
+    m_pool.start( new FunctionRunnable( task ));
+  }
+
+  void MeshExporter::flushChunks( )
+  {
+    auto meshChunk = m_meshChunks.find( m_nextChunk );
+    while ( meshChunk != m_meshChunks.end( ))
+    {
+      m_mergeWriter->append( meshChunk->second );
+      m_meshChunks.erase( meshChunk );
+      meshChunk = m_meshChunks.find( ++m_nextChunk );
+    }
+
+    auto chunk = m_chunks.find( m_nextChunk );
+    while ( chunk != m_chunks.end( ))
+    {
+      m_mergeFile << chunk->second;
+      m_chunks.erase( chunk );
+      chunk = m_chunks.find( ++m_nextChunk );
+    }
+  }
+
+  void MeshExporter::onWritten( const QString& error )
+  {
+    --m_inFlight;
+
+    if ( !error.isEmpty( ) && m_error.isEmpty( ))
+    {
+      m_error = error;
+      cancel( );
+    }
+
+    ++m_written;
+    emit progress( m_written );
+
+    checkFinished( );
+  }
+
+  void MeshExporter::writeMergedMesh( )
+  {
+    QMutexLocker lock( &m_mergeMutex );
+    try
+    {
+      m_mergeWriter->close( );
+    }
+    catch ( const std::exception& e )
+    {
+      m_error = QString::fromStdString( e.what( ));
+      QFile::remove( m_path );
+    }
+  }
+
+  void MeshExporter::checkFinished( )
+  {
+    if ( m_finished || m_timer.isActive( ) || m_inFlight > 0 )
+      return;
+
+    if ( !m_cancelled && m_next < m_ids.size( ))
+      return;
+
+    m_finished = true;
+
+    if ( m_mergeWriter )
+    {
+      if ( !m_cancelled )
+        writeMergedMesh( );
+      m_mergeWriter.reset( );
+    }
+
+    if ( m_mode == Mode::Merged && m_mergeFile.is_open( ))
+    {
+      QMutexLocker lock( &m_mergeMutex );
+      m_mergeFile.close( );
+      if ( m_cancelled )
+        QFile::remove( m_path );
+    }
+
+    emit finished( m_error );
+  }
+}
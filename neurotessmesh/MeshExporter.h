@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_MESHEXPORTER_H_
+#define NEUROTESSMESH_MESHEXPORTER_H_
+
+// Qt
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <QMutex>
+#include <QString>
+
+// Project
+#include "BinaryMeshWriter.h"
+#include "MeshPostProcessor.h"
+
+// C++
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class QOpenGLWidget;
+
+namespace neurotessmesh
+{
+  class Scene;
+
+  /** \class MeshExporter
+   * \brief Exports the tessellated meshes of several neurons without
+   * blocking the UI.
+   *
+   * Neurons are extracted one per event loop iteration in the GL thread and
+   * the extracted buffers are written by a pool of threads, either one file
+   * per neuron or a single file in world coordinates. In the merged file the
+   * neuron chunks are formatted in parallel and appended in order, so only
+   * the meshes in flight are kept in memory. Meshes can be written as OBJ,
+   * binary PLY or glTF binary (GLB) files.
+   *
+   */
+  class MeshExporter
+    : public QObject
+  {
+  Q_OBJECT
+  public:
+    enum class Mode
+    {
+      PerNeuron , Merged
+    };
+
+    enum class Format
+    {
+      OBJ , PLY , GLB
+    };
+
+    /** \brief Returns the file extension of the format, without the dot.
+     * \param[in] format Output format.
+     *
+     */
+    static QString extension( const Format format );
+
+    /** \brief MeshExporter class constructor.
+     * \param[in] scene Scene to extract the meshes from.
+     * \param[in] widget Widget owning the scene GL context.
+     * \param[in] ids Ids of the neurons to export.
+     * \param[in] path Output directory in PerNeuron mode, output file
+     * in Merged mode.
+     * \param[in] mode Export mode.
+     * \param[in] format Output file format.
+     * \param[in] parent Raw pointer of the parent object.
+     *
+     */
+    explicit MeshExporter( std::shared_ptr< Scene > scene ,
+                           QOpenGLWidget* widget ,
+                           const std::vector< unsigned int >& ids ,
+                           const QString& path ,
+                           const Mode mode ,
+                           const Format format ,
+                           QObject* parent = nullptr );
+
+    /** \brief MeshExporter class virtual destructor. Waits for the writers.
+     *
+     */
+    virtual ~MeshExporter( );
+
+    /** \brief Number of neurons to export.
+     *
+     */
+    int total( ) const
+    { return static_cast< int >( m_ids.size( )); }
+
+    /** \brief Sets the welding and decimation applied to each neuron mesh
+     * in the writer threads. Only used by the PLY and GLB formats.
+     * \param[in] options Post-processing options.
+     *
+     */
+    void setPostProcessing( const MeshPostProcessor::Options& options )
+    { m_postProcessing = options; }
+
+  public slots:
+
+    /** \brief Starts the export.
+     *
+     */
+    void start( );
+
+    /** \brief Stops the export. finished() is emitted once the running
+     * writers end.
+     *
+     */
+    void cancel( );
+
+  signals:
+
+    /** \brief Reports the number of neurons written.
+     *
+     */
+    void progress( int written );
+
+    /** \brief Emitted when the export ends.
+     * \param[in] error Error description or empty if none or cancelled.
+     *
+     */
+    void finished( const QString& error );
+
+  private slots:
+
+    /** \brief Extracts the next neuron and hands it to the writers.
+     *
+     */
+    void extractNext( );
+
+    /** \brief Called in the object thread when a writer ends.
+     * \param[in] error Writer error or empty if none.
+     *
+     */
+    void onWritten( const QString& error );
+
+  private:
+    /** \brief Appends the consecutive formatted chunks to the merged file.
+     * Must be called with m_mergeMutex locked.
+     *
+     */
+    void flushChunks( );
+
+    /** \brief Completes the merged binary file.
+     *
+     */
+    void writeMergedMesh( );
+
+    /** \brief Emits finished() if nothing else is running.
+     *
+     */
+    void checkFinished( );
+
+    std::shared_ptr< Scene > m_scene;    /** source scene.                 */
+    QOpenGLWidget* m_widget;             /** owner of the GL context.      */
+    std::vector< unsigned int > m_ids;   /** neurons to export.            */
+    const QString m_path;                /** output directory or file.     */
+    const Mode m_mode;                   /** export mode.                  */
+    const Format m_format;               /** output file format.           */
+    MeshPostProcessor::Options m_postProcessing; /** binary mesh cleanup.  */
+
+    QThreadPool m_pool;                  /** writer threads.               */
+    QTimer m_timer;                      /** drives the extraction.        */
+    size_t m_next;                       /** next neuron to extract.       */
+    size_t m_sequence;                   /** next extracted mesh chunk.    */
+    int m_inFlight;                      /** extracted but not written.    */
+    int m_written;                       /** written neurons.              */
+    size_t m_vertexOffset;               /** merged file vertex count.     */
+    std::atomic< bool > m_cancelled;     /** true once cancelled or failed. */
+    QString m_error;                     /** first error.                  */
+    bool m_finished;                     /** true once finished() emitted. */
+
+    QMutex m_mergeMutex;                 /** protects the members below.   */
+    std::ofstream m_mergeFile;           /** merged output file.           */
+    std::map< size_t , std::string > m_chunks; /** formatted, not written. */
+    std::map< size_t , IndexedMesh > m_meshChunks; /** binary, not merged. */
+    std::unique_ptr< StreamingMeshWriter > m_mergeWriter; /** binary file. */
+    size_t m_nextChunk;                  /** next chunk to append.         */
+  };
+}
+
+#endif /* NEUROTESSMESH_MESHEXPORTER_H_ */
@@ -0,0 +1,595 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MeshPostProcessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+/*
+ * Quadric and QuadricDecimator are adapted from Fast Quadric Mesh
+ * Simplification <https://github.com/sp4cerat/Fast-Quadric-Mesh-Simplification>
+ * and remain under its license:
+ *
+ * Mesh Simplification (C) by Sven Forstmann in 2014
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+namespace
+{
+  /** \brief Symmetric 4x4 matrix holding the quadric of a vertex.
+   *
+   */
+  class Quadric
+  {
+  public:
+    Quadric( )
+    { std::fill( _m , _m + 10 , 0.0 ); }
+
+    //! Quadric of the plane ax + by + cz + d = 0
+    Quadric( double a , double b , double c , double d )
+    {
+      _m[ 0 ] = a * a; _m[ 1 ] = a * b; _m[ 2 ] = a * c; _m[ 3 ] = a * d;
+      _m[ 4 ] = b * b; _m[ 5 ] = b * c; _m[ 6 ] = b * d;
+      _m[ 7 ] = c * c; _m[ 8 ] = c * d;
+      _m[ 9 ] = d * d;
+    }
+
+    Quadric operator+( const Quadric& other ) const
+    {
+      Quadric result;
+      for ( int i = 0; i < 10; ++i )
+        result._m[ i ] = _m[ i ] + other._m[ i ];
+      return result;
+    }
+
+    Quadric& operator+=( const Quadric& other )
+    {
+      for ( int i = 0; i < 10; ++i )
+        _m[ i ] += other._m[ i ];
+      return *this;
+    }
+
+    double det( int a11 , int a12 , int a13 ,
+                int a21 , int a22 , int a23 ,
+                int a31 , int a32 , int a33 ) const
+    {
+      return _m[ a11 ] * _m[ a22 ] * _m[ a33 ] +
+        _m[ a13 ] * _m[ a21 ] * _m[ a32 ] +
+        _m[ a12 ] * _m[ a23 ] * _m[ a31 ] -
+        _m[ a13 ] * _m[ a22 ] * _m[ a31 ] -
+        _m[ a11 ] * _m[ a23 ] * _m[ a32 ] -
+        _m[ a12 ] * _m[ a21 ] * _m[ a33 ];
+    }
+
+    //! Squared distance of the point to the planes of the quadric
+    double error( const Eigen::Vector3d& p ) const
+    {
+      return _m[ 0 ] * p.x( ) * p.x( ) + 2 * _m[ 1 ] * p.x( ) * p.y( ) +
+        2 * _m[ 2 ] * p.x( ) * p.z( ) + 2 * _m[ 3 ] * p.x( ) +
+        _m[ 4 ] * p.y( ) * p.y( ) + 2 * _m[ 5 ] * p.y( ) * p.z( ) +
+        2 * _m[ 6 ] * p.y( ) + _m[ 7 ] * p.z( ) * p.z( ) +
+        2 * _m[ 8 ] * p.z( ) + _m[ 9 ];
+    }
+
+  private:
+    double _m[ 10 ];
+  };
+
+  /** \brief Edge collapse decimation driven by an error threshold that
+   * grows every pass, so the cheapest collapses are done first without
+   * keeping a priority queue of all the edges.
+   *
+   */
+  class QuadricDecimator
+  {
+  public:
+    explicit QuadricDecimator( const neurotessmesh::IndexedMesh& mesh )
+    {
+      _vertices.resize( mesh.numVertices( ));
+      for ( size_t i = 0; i < _vertices.size( ); ++i )
+        _vertices[ i ].p = Eigen::Vector3d( mesh.positions[ i * 3 ] ,
+                                            mesh.positions[ i * 3 + 1 ] ,
+                                            mesh.positions[ i * 3 + 2 ]);
+
+      _triangles.resize( mesh.numTriangles( ));
+      for ( size_t i = 0; i < _triangles.size( ); ++i )
+        for ( size_t j = 0; j < 3; ++j )
+          _triangles[ i ].v[ j ] = mesh.indices[ i * 3 + j ];
+    }
+
+    void run( size_t targetTriangles , double maxError )
+    {
+      const size_t triangleCount = _triangles.size( );
+      const double maxSquaredError = maxError * maxError;
+      size_t deletedTriangles = 0;
+      std::vector< bool > deleted0;
+      std::vector< bool > deleted1;
+
+      for ( int iteration = 0; iteration < MAX_ITERATIONS; ++iteration )
+      {
+        if ( triangleCount - deletedTriangles <= targetTriangles )
+          break;
+
+        if ( iteration % UPDATE_INTERVAL == 0 )
+          updateMesh( iteration );
+
+        for ( auto& triangle: _triangles )
+          triangle.dirty = false;
+
+        double threshold = 1e-9 * std::pow( iteration + 3.0 , AGGRESSIVENESS );
+        const bool errorLimited = maxError > 0.0 && threshold >= maxSquaredError;
+        if ( errorLimited )
+          threshold = maxSquaredError;
+
+        size_t collapsed = 0;
+        for ( auto& triangle: _triangles )
+        {
+          if ( triangle.err[ 3 ] > threshold || triangle.deleted ||
+               triangle.dirty )
+            continue;
+
+          for ( int j = 0; j < 3; ++j )
+          {
+            if ( triangle.err[ j ] > threshold )
+              continue;
+
+            const uint32_t i0 = triangle.v[ j ];
+            const uint32_t i1 = triangle.v[( j + 1 ) % 3 ];
+            auto& v0 = _vertices[ i0 ];
+            auto& v1 = _vertices[ i1 ];
+            if ( v0.border != v1.border )
+              continue;
+
+            Eigen::Vector3d p;
+            calculateError( i0 , i1 , p );
+
+            deleted0.assign( v0.tcount , false );
+            deleted1.assign( v1.tcount , false );
+            if ( flipped( p , i1 , v0 , deleted0 ) ||
+                 flipped( p , i0 , v1 , deleted1 ))
+              continue;
+
+            v0.p = p;
+            v0.q += v1.q;
+
+            const auto tstart = static_cast< uint32_t >( _refs.size( ));
+            updateTriangles( i0 , v0 , deleted0 , deletedTriangles );
+            updateTriangles( i0 , v1 , deleted1 , deletedTriangles );
+            const auto tcount = static_cast< uint32_t >( _refs.size( )) - tstart;
+
+            if ( tcount <= v0.tcount )
+            {
+              // Reuses the old references slot, avoiding the refs growth.
+              std::copy( _refs.begin( ) + tstart , _refs.end( ) ,
+                         _refs.begin( ) + v0.tstart );
+              _refs.resize( tstart );
+            }
+            else
+              v0.tstart = tstart;
+            v0.tcount = tcount;
+            ++collapsed;
+            break;
+          }
+
+          if ( triangleCount - deletedTriangles <= targetTriangles )
+            break;
+        }
+
+        if ( errorLimited && collapsed == 0 )
+          break;
+      }
+
+      compactMesh( );
+    }
+
+    void store( neurotessmesh::IndexedMesh& mesh ) const
+    {
+      mesh.positions.resize( _vertices.size( ) * 3 );
+      for ( size_t i = 0; i < _vertices.size( ); ++i )
+        for ( size_t j = 0; j < 3; ++j )
+          mesh.positions[ i * 3 + j ] = static_cast< float >( _vertices[ i ].p[ j ]);
+
+      mesh.indices.resize( _triangles.size( ) * 3 );
+      for ( size_t i = 0; i < _triangles.size( ); ++i )
+        for ( size_t j = 0; j < 3; ++j )
+          mesh.indices[ i * 3 + j ] = _triangles[ i ].v[ j ];
+    }
+
+  private:
+    static constexpr int MAX_ITERATIONS = 100;
+    static constexpr int UPDATE_INTERVAL = 5;
+    static constexpr double AGGRESSIVENESS = 7.0;
+
+    struct Triangle
+    {
+      uint32_t v[ 3 ];
+      double err[ 4 ];
+      bool deleted = false;
+      bool dirty = false;
+      Eigen::Vector3d n;
+    };
+
+    struct Vertex
+    {
+      Eigen::Vector3d p;
+      Quadric q;
+      uint32_t tstart = 0;
+      uint32_t tcount = 0;
+      bool border = false;
+    };
+
+    struct Ref
+    {
+      uint32_t tid;
+      uint32_t tvertex;
+    };
+
+    double calculateError( uint32_t id0 , uint32_t id1 ,
+                           Eigen::Vector3d& result ) const
+    {
+      const Quadric q = _vertices[ id0 ].q + _vertices[ id1 ].q;
+      const bool border = _vertices[ id0 ].border && _vertices[ id1 ].border;
+      const double det = q.det( 0 , 1 , 2 , 1 , 4 , 5 , 2 , 5 , 7 );
+
+      if ( det != 0.0 && !border )
+      {
+        result = Eigen::Vector3d(
+          -1.0 / det * q.det( 1 , 2 , 3 , 4 , 5 , 6 , 5 , 7 , 8 ) ,
+          1.0 / det * q.det( 0 , 2 , 3 , 1 , 5 , 6 , 2 , 7 , 8 ) ,
+          -1.0 / det * q.det( 0 , 1 , 3 , 1 , 4 , 6 , 2 , 5 , 8 ));
+        return q.error( result );
+      }
+
+      // Not invertible, takes the best of the endpoints and the midpoint.
+      const Eigen::Vector3d candidates[ 3 ] = {
+        _vertices[ id0 ].p , _vertices[ id1 ].p ,
+        ( _vertices[ id0 ].p + _vertices[ id1 ].p ) * 0.5 };
+      double error = std::numeric_limits< double >::max( );
+      for ( const auto& candidate: candidates )
+      {
+        const double candidateError = q.error( candidate );
+        if ( candidateError < error )
+        {
+          error = candidateError;
+          result = candidate;
+        }
+      }
+      return error;
+    }
+
+    //! Checks if moving the vertex to p flips any of its triangles
+    bool flipped( const Eigen::Vector3d& p , uint32_t other ,
+                  const Vertex& vertex , std::vector< bool >& deleted ) const
+    {
+      for ( uint32_t k = 0; k < vertex.tcount; ++k )
+      {
+        const auto& ref = _refs[ vertex.tstart + k ];
+        const auto& triangle = _triangles[ ref.tid ];
+        if ( triangle.deleted )
+          continue;
+
+        const uint32_t id1 = triangle.v[( ref.tvertex + 1 ) % 3 ];
+        const uint32_t id2 = triangle.v[( ref.tvertex + 2 ) % 3 ];
+        if ( id1 == other || id2 == other )
+        {
+          deleted[ k ] = true;
+          continue;
+        }
+
+        const Eigen::Vector3d d1 = ( _vertices[ id1 ].p - p ).normalized( );
+        const Eigen::Vector3d d2 = ( _vertices[ id2 ].p - p ).normalized( );
+        if ( std::fabs( d1.dot( d2 )) > 0.999 )
+          return true;
+
+        const Eigen::Vector3d n = d1.cross( d2 ).normalized( );
+        deleted[ k ] = false;
+        if ( n.dot( triangle.n ) < 0.2 )
+          return true;
+      }
+      return false;
+    }
+
+    void updateTriangles( uint32_t i0 , const Vertex& vertex ,
+                          const std::vector< bool >& deleted ,
+                          size_t& deletedTriangles )
+    {
+      Eigen::Vector3d p;
+      for ( uint32_t k = 0; k < vertex.tcount; ++k )
+      {
+        const Ref ref = _refs[ vertex.tstart + k ];
+        auto& triangle = _triangles[ ref.tid ];
+        if ( triangle.deleted )
+          continue;
+
+        if ( deleted[ k ])
+        {
+          triangle.deleted = true;
+          ++deletedTriangles;
+          continue;
+        }
+
+        triangle.v[ ref.tvertex ] = i0;
+        triangle.dirty = true;
+        updateErrors( triangle , p );
+        _refs.push_back( ref );
+      }
+    }
+
+    void updateErrors( Triangle& triangle , Eigen::Vector3d& p ) const
+    {
+      for ( int j = 0; j < 3; ++j )
+        triangle.err[ j ] = calculateError( triangle.v[ j ] ,
+                                            triangle.v[( j + 1 ) % 3 ] , p );
+      triangle.err[ 3 ] = std::min( triangle.err[ 0 ] ,
+                                    std::min( triangle.err[ 1 ] ,
+                                              triangle.err[ 2 ]));
+    }
+
+    void updateMesh( int iteration )
+    {
+      if ( iteration > 0 )
+      {
+        _triangles.erase( std::remove_if(
+          _triangles.begin( ) , _triangles.end( ) ,
+          []( const Triangle& triangle ){ return triangle.deleted; }) ,
+          _triangles.end( ));
+      }
+
+      // Vertex to triangles references.
+      for ( auto& vertex: _vertices )
+      {
+        vertex.tstart = 0;
+        vertex.tcount = 0;
+      }
+      for ( const auto& triangle: _triangles )
+        for ( const auto v: triangle.v )
+          ++_vertices[ v ].tcount;
+      uint32_t tstart = 0;
+      for ( auto& vertex: _vertices )
+      {
+        vertex.tstart = tstart;
+        tstart += vertex.tcount;
+        vertex.tcount = 0;
+      }
+      _refs.resize( _triangles.size( ) * 3 );
+      for ( uint32_t i = 0; i < _triangles.size( ); ++i )
+        for ( uint32_t j = 0; j < 3; ++j )
+        {
+          auto& vertex = _vertices[ _triangles[ i ].v[ j ]];
+          _refs[ vertex.tstart + vertex.tcount ] = Ref{ i , j };
+          ++vertex.tcount;
+        }
+
+      if ( iteration > 0 )
+        return;
+
+      // Border vertices share an edge with a single triangle.
+      std::vector< uint32_t > counts;
+      std::vector< uint32_t > ids;
+      for ( auto& vertex: _vertices )
+      {
+        counts.clear( );
+        ids.clear( );
+        for ( uint32_t k = 0; k < vertex.tcount; ++k )
+        {
+          const auto& triangle = _triangles[ _refs[ vertex.tstart + k ].tid ];
+          for ( const auto id: triangle.v )
+          {
+            const auto found = std::find( ids.begin( ) , ids.end( ) , id );
+            if ( found == ids.end( ))
+            {
+              ids.push_back( id );
+              counts.push_back( 1 );
+            }
+            else
+              ++counts[ found - ids.begin( )];
+          }
+        }
+        for ( size_t j = 0; j < ids.size( ); ++j )
+          if ( counts[ j ] == 1 )
+            _vertices[ ids[ j ]].border = true;
+      }
+
+      for ( auto& triangle: _triangles )
+      {
+        const auto& p0 = _vertices[ triangle.v[ 0 ]].p;
+        triangle.n = ( _vertices[ triangle.v[ 1 ]].p - p0 ).cross(
+          _vertices[ triangle.v[ 2 ]].p - p0 ).normalized( );
+        const Quadric plane( triangle.n.x( ) , triangle.n.y( ) ,
+                             triangle.n.z( ) , -triangle.n.dot( p0 ));
+        for ( const auto v: triangle.v )
+          _vertices[ v ].q += plane;
+      }
+
+      Eigen::Vector3d p;
+      for ( auto& triangle: _triangles )
+        updateErrors( triangle , p );
+    }
+
+    void compactMesh( )
+    {
+      _triangles.erase( std::remove_if(
+        _triangles.begin( ) , _triangles.end( ) ,
+        []( const Triangle& triangle ){ return triangle.deleted; }) ,
+        _triangles.end( ));
+
+      for ( auto& vertex: _vertices )
+        vertex.tcount = 0;
+      for ( const auto& triangle: _triangles )
+        for ( const auto v: triangle.v )
+          _vertices[ v ].tcount = 1;
+
+      uint32_t used = 0;
+      for ( auto& vertex: _vertices )
+        if ( vertex.tcount )
+        {
+          vertex.tstart = used;
+          _vertices[ used++ ].p = vertex.p;
+        }
+      for ( auto& triangle: _triangles )
+        for ( auto& v: triangle.v )
+          v = _vertices[ v ].tstart;
+      _vertices.resize( used );
+    }
+
+    std::vector< Vertex > _vertices;
+    std::vector< Triangle > _triangles;
+    std::vector< Ref > _refs;
+  };
+
+  struct CellHash
+  {
+    size_t operator( )( const Eigen::Vector3i& cell ) const
+    {
+      return static_cast< size_t >( cell.x( )) * 73856093u ^
+        static_cast< size_t >( cell.y( )) * 19349663u ^
+        static_cast< size_t >( cell.z( )) * 83492791u;
+    }
+  };
+
+  struct CellEqual
+  {
+    bool operator( )( const Eigen::Vector3i& a ,
+                      const Eigen::Vector3i& b ) const
+    { return a == b; }
+  };
+}
+
+namespace neurotessmesh
+{
+  void MeshPostProcessor::process( IndexedMesh& mesh , const Options& options )
+  {
+    if ( options.weld )
+      weld( mesh , options.weldTolerance );
+
+    if ( options.triangleRatio < 1.0f || options.maxError > 0.0f )
+    {
+      const auto ratio = std::max( 0.0f , options.triangleRatio );
+      const auto target = ratio < 1.0f ?
+        static_cast< size_t >( mesh.numTriangles( ) * ratio ) : 0;
+      decimate( mesh , target , options.maxError );
+    }
+  }
+
+  void MeshPostProcessor::weld( IndexedMesh& mesh , float tolerance )
+  {
+    if ( mesh.numVertices( ) == 0 || tolerance <= 0.0f )
+      return;
+
+    // Grid cells as big as the tolerance, so close vertices are always in
+    // neighbouring cells.
+    const float invCell = 1.0f / tolerance;
+    const float squaredTolerance = tolerance * tolerance;
+    std::unordered_multimap< Eigen::Vector3i , uint32_t , CellHash , CellEqual >
+      grid;
+    grid.reserve( mesh.numVertices( ));
+
+    std::vector< uint32_t > remap( mesh.numVertices( ));
+    std::vector< float > positions;
+    positions.reserve( mesh.positions.size( ));
+
+    for ( size_t i = 0; i < mesh.numVertices( ); ++i )
+    {
+      const Eigen::Map< const Eigen::Vector3f > position( &mesh.positions[ i * 3 ]);
+      const Eigen::Vector3i cell =
+        ( position * invCell ).array( ).floor( ).cast< int >( );
+
+      bool found = false;
+      for ( int x = -1; x <= 1 && !found; ++x )
+        for ( int y = -1; y <= 1 && !found; ++y )
+          for ( int z = -1; z <= 1 && !found; ++z )
+          {
+            const auto range = grid.equal_range( cell + Eigen::Vector3i( x , y , z ));
+            for ( auto candidate = range.first; candidate != range.second;
+                  ++candidate )
+            {
+              const Eigen::Map< const Eigen::Vector3f > other(
+                &positions[ candidate->second * 3 ]);
+              if (( other - position ).squaredNorm( ) <= squaredTolerance )
+              {
+                remap[ i ] = candidate->second;
+                found = true;
+                break;
+              }
+            }
+          }
+
+      if ( !found )
+      {
+        remap[ i ] = static_cast< uint32_t >( positions.size( ) / 3 );
+        grid.emplace( cell , remap[ i ]);
+        positions.insert( positions.end( ) , position.data( ) ,
+                          position.data( ) + 3 );
+      }
+    }
+
+    std::vector< uint32_t > indices;
+    indices.reserve( mesh.indices.size( ));
+    for ( size_t i = 0; i < mesh.indices.size( ); i += 3 )
+    {
+      const uint32_t a = remap[ mesh.indices[ i ]];
+      const uint32_t b = remap[ mesh.indices[ i + 1 ]];
+      const uint32_t c = remap[ mesh.indices[ i + 2 ]];
+      if ( a == b || b == c || a == c )
+        continue;
+      indices.push_back( a );
+      indices.push_back( b );
+      indices.push_back( c );
+    }
+
+    mesh.positions = std::move( positions );
+    mesh.indices = std::move( indices );
+  }
+
+  void MeshPostProcessor::decimate( IndexedMesh& mesh , size_t targetTriangles ,
+                                    float maxError )
+  {
+    if ( mesh.numTriangles( ) == 0 ||
+         ( targetTriangles == 0 && maxError <= 0.0f ) ||
+         ( maxError <= 0.0f && targetTriangles >= mesh.numTriangles( )))
+      return;
+
+    QuadricDecimator decimator( mesh );
+    decimator.run( targetTriangles , maxError );
+    decimator.store( mesh );
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_MESHPOSTPROCESSOR_H_
+#define NEUROTESSMESH_MESHPOSTPROCESSOR_H_
+
+// Project
+#include "BinaryMeshWriter.h"
+
+namespace neurotessmesh
+{
+  /** \class MeshPostProcessor
+   * \brief Cleans up extracted meshes before exporting them: welds the
+   * vertices duplicated along the patch borders and reduces the number of
+   * triangles with quadric error edge collapses.
+   *
+   */
+  class MeshPostProcessor
+  {
+  public:
+    /** \brief Post-processing options. The default ones leave the mesh
+     * untouched.
+     *
+     */
+    struct Options
+    {
+      //! true to weld the vertices closer than weldTolerance
+      bool weld = false;
+
+      //! Maximum distance between welded vertices
+      float weldTolerance = 1e-3f;
+
+      //! Fraction of triangles to keep, in (0,1]
+      float triangleRatio = 1.0f;
+
+      //! Maximum decimation error as a distance, 0 for no limit
+      float maxError = 0.0f;
+
+      /** \brief Returns true if the options modify the meshes.
+       *
+       */
+      bool enabled( ) const
+      { return weld || triangleRatio < 1.0f || maxError > 0.0f; }
+    };
+
+    /** \brief Applies the options to the mesh. Welding is done before the
+     * decimation, otherwise the patch borders could not be collapsed.
+     * \param[in,out] mesh Mesh to process.
+     * \param[in] options Post-processing options.
+     *
+     */
+    static void process( IndexedMesh& mesh , const Options& options );
+
+    /** \brief Merges the vertices closer than the tolerance using a spatial
+     * hash and removes the triangles that become degenerate.
+     * \param[in,out] mesh Mesh to weld.
+     * \param[in] tolerance Maximum distance between merged vertices.
+     *
+     */
+    static void weld( IndexedMesh& mesh , float tolerance );
+
+    /** \brief Collapses edges in increasing quadric error order until the
+     * mesh has the target number of triangles or no edge can be collapsed
+     * under the maximum error.
+     * \param[in,out] mesh Mesh to decimate.
+     * \param[in] targetTriangles Number of triangles to reach, 0 to only
+     * stop on the error limit.
+     * \param[in] maxError Maximum error as a distance, 0 for no limit.
+     *
+     */
+    static void decimate( IndexedMesh& mesh , size_t targetTriangles ,
+                          float maxError = 0.0f );
+  };
+}
+
+#endif /* NEUROTESSMESH_MESHPOSTPROCESSOR_H_ */
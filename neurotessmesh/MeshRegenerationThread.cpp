@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Project
+#include "MeshRegenerationThread.h"
+
+// neurolots
+#include <nlgenerator/nlgenerator.h>
+
+// Qt
+#include <QMutexLocker>
+
+namespace neurotessmesh
+{
+  MeshRegenerationThread::MeshRegenerationThread( QObject* parent )
+    : QThread( parent )
+    , m_pending{ nullptr , 1.0f , {} }
+    , m_hasPending{ false }
+    , m_busy{ false }
+    , m_stop{ false }
+    , m_generation{ 0 }
+    , m_mesh{ nullptr }
+    , m_meshRequest{ nullptr , 1.0f , {} }
+  { }
+
+  MeshRegenerationThread::~MeshRegenerationThread( )
+  {
+    {
+      QMutexLocker lock( &m_mutex );
+      m_stop = true;
+      m_hasPending = false;
+      m_condition.wakeAll( );
+    }
+    wait( );
+
+    delete m_mesh;
+  }
+
+  void MeshRegenerationThread::request( nsol::NeuronMorphologyPtr morphology ,
+                                        float alphaRadius ,
+                                        const std::vector< float >& alphaNeurites )
+  {
+    {
+      QMutexLocker lock( &m_mutex );
+      m_pending = Request{ morphology , alphaRadius , alphaNeurites };
+      m_hasPending = true;
+      m_condition.wakeAll( );
+    }
+
+    if ( !isRunning( ))
+      start( QThread::LowPriority );
+  }
+
+  void MeshRegenerationThread::cancel( )
+  {
+    QMutexLocker lock( &m_mutex );
+    m_hasPending = false;
+    ++m_generation;
+
+    while ( m_busy )
+      m_condition.wait( &m_mutex );
+
+    delete m_mesh;
+    m_mesh = nullptr;
+  }
+
+  void MeshRegenerationThread::discard( )
+  {
+    QMutexLocker lock( &m_mutex );
+    m_hasPending = false;
+    ++m_generation;
+
+    delete m_mesh;
+    m_mesh = nullptr;
+  }
+
+  nlgeometry::MeshPtr MeshRegenerationThread::takeMesh(
+    nsol::NeuronMorphologyPtr& morphology , float& alphaRadius ,
+    std::vector< float >& alphaNeurites )
+  {
+    QMutexLocker lock( &m_mutex );
+
+    auto mesh = m_mesh;
+    morphology = m_meshRequest.morphology;
+    alphaRadius = m_meshRequest.alphaRadius;
+    alphaNeurites = m_meshRequest.alphaNeurites;
+    m_mesh = nullptr;
+
+    return mesh;
+  }
+
+  void MeshRegenerationThread::run( )
+  {
+    QMutexLocker lock( &m_mutex );
+
+    while ( !m_stop )
+    {
+      if ( !m_hasPending )
+      {
+        m_condition.wait( &m_mutex );
+        continue;
+      }
+
+      const Request request = m_pending;
+      const auto generation = m_generation;
+      m_hasPending = false;
+      m_busy = true;
+
+      lock.unlock( );
+      auto mesh = nlgenerator::MeshGenerator::generateMesh(
+        request.morphology , request.alphaRadius , request.alphaNeurites );
+      lock.relock( );
+
+      m_busy = false;
+      m_condition.wakeAll( );
+
+      // Drop the result if cancelled meanwhile, replace any mesh not taken.
+      if ( !mesh || generation != m_generation || m_stop )
+      {
+        delete mesh;
+        continue;
+      }
+
+      delete m_mesh;
+      m_mesh = mesh;
+      m_meshRequest = request;
+
+      lock.unlock( );
+      emit meshReady( );
+      lock.relock( );
+    }
+  }
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_MESHREGENERATIONTHREAD_H_
+#define NEUROTESSMESH_MESHREGENERATIONTHREAD_H_
+
+// Qt
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+// NSOL
+#include <nsol/nsol.h>
+
+// neurolots
+#include <nlgeometry/nlgeometry.h>
+
+// C++
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class MeshRegenerationThread
+   * \brief Generates the edited neuron mesh with new parameters in a worker
+   * thread.
+   *
+   * Only the latest request is kept, so the intermediate values of a dragged
+   * slider are skipped. Generated meshes only contain CPU data, the receiver
+   * of meshReady() takes the mesh and uploads it in the GL thread.
+   *
+   */
+  class MeshRegenerationThread
+    : public QThread
+  {
+  Q_OBJECT
+  public:
+    /** \brief MeshRegenerationThread class constructor.
+     * \param[in] parent Raw pointer of the parent object.
+     *
+     */
+    explicit MeshRegenerationThread( QObject* parent = nullptr );
+
+    /** \brief MeshRegenerationThread class virtual destructor. Stops the
+     * thread and deletes any mesh not taken.
+     *
+     */
+    virtual ~MeshRegenerationThread( );
+
+    /** \brief Requests the generation of a mesh, replacing any pending
+     * request. Starts the thread if not running.
+     * \param[in] morphology Simplified neuron morphology.
+     * \param[in] alphaRadius Soma radius factor.
+     * \param[in] alphaNeurites Neurite factors.
+     *
+     */
+    void request( nsol::NeuronMorphologyPtr morphology , float alphaRadius ,
+                  const std::vector< float >& alphaNeurites );
+
+    /** \brief Discards the pending request and the generated mesh and waits
+     * for the current generation to finish.
+     *
+     */
+    void cancel( );
+
+    /** \brief Discards the pending request and the results of the current
+     * generation without waiting for it.
+     *
+     */
+    void discard( );
+
+    /** \brief Takes ownership of the last generated mesh.
+     * \param[out] morphology Morphology of the mesh.
+     * \param[out] alphaRadius Soma radius factor of the mesh.
+     * \param[out] alphaNeurites Neurite factors of the mesh.
+     * \returns Generated mesh or nullptr if none.
+     *
+     */
+    nlgeometry::MeshPtr takeMesh( nsol::NeuronMorphologyPtr& morphology ,
+                                  float& alphaRadius ,
+                                  std::vector< float >& alphaNeurites );
+
+  signals:
+
+    /** \brief Emitted when a mesh has been generated.
+     *
+     */
+    void meshReady( );
+
+  protected:
+
+    virtual void run( ) override;
+
+  private:
+    struct Request
+    {
+      nsol::NeuronMorphologyPtr morphology;
+      float alphaRadius;
+      std::vector< float > alphaNeurites;
+    };
+
+    QMutex m_mutex;              /** protects the members below.       */
+    QWaitCondition m_condition;  /** signals new requests and idleness. */
+    Request m_pending;           /** latest request.                   */
+    bool m_hasPending;           /** true if m_pending is valid.       */
+    bool m_busy;                 /** true while generating.            */
+    bool m_stop;                 /** true to end the thread.           */
+    unsigned long m_generation;  /** increased on every cancel.        */
+
+    nlgeometry::MeshPtr m_mesh; /** generated mesh not taken.      */
+    Request m_meshRequest;      /** request that generated m_mesh. */
+  };
+}
+
+#endif /* NEUROTESSMESH_MESHREGENERATIONTHREAD_H_ */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MeshResidencyManager.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace neurotessmesh
+{
+  MeshResidencyManager::MeshResidencyManager( )
+    : _budget( 0 )
+    , _usage( 0 )
+    , _reserved( 0 )
+    , _policy( LEAST_RECENTLY_USED )
+    , _frame( 0 )
+    , _evictions( 0 )
+  { }
+
+  void MeshResidencyManager::budget( size_t bytes_ )
+  {
+    _budget = bytes_;
+  }
+
+  size_t MeshResidencyManager::budget( ) const
+  {
+    return _budget;
+  }
+
+  void MeshResidencyManager::policy( EvictionPolicy policy_ )
+  {
+    _policy = policy_;
+  }
+
+  MeshResidencyManager::EvictionPolicy MeshResidencyManager::policy( ) const
+  {
+    return _policy;
+  }
+
+  size_t MeshResidencyManager::usage( ) const
+  {
+    return _usage;
+  }
+
+  void MeshResidencyManager::reserve( size_t bytes_ )
+  {
+    _usage = _usage - _reserved + bytes_;
+    _reserved = bytes_;
+  }
+
+  size_t MeshResidencyManager::residentMeshes( ) const
+  {
+    return _entries.size( );
+  }
+
+  unsigned long MeshResidencyManager::evictions( ) const
+  {
+    return _evictions;
+  }
+
+  bool MeshResidencyManager::full( ) const
+  {
+    return _budget > 0 && _usage >= _budget;
+  }
+
+  void MeshResidencyManager::nextFrame( )
+  {
+    ++_frame;
+  }
+
+  void MeshResidencyManager::insert( nsol::MorphologyPtr morphology ,
+                                     size_t bytes )
+  {
+    auto entryIt = _entries.find( morphology );
+    if ( entryIt != _entries.end( ))
+    {
+      _usage -= entryIt->second.bytes;
+      entryIt->second.bytes = bytes;
+      entryIt->second.lastUse = _frame;
+    }
+    else
+    {
+      _entries[ morphology ] = Entry{ bytes , _frame , 0 ,
+                                      std::numeric_limits< float >::max( )};
+    }
+    _usage += bytes;
+  }
+
+  void MeshResidencyManager::remove( nsol::MorphologyPtr morphology )
+  {
+    auto entryIt = _entries.find( morphology );
+    if ( entryIt == _entries.end( ))
+      return;
+
+    _usage -= entryIt->second.bytes;
+    _entries.erase( entryIt );
+  }
+
+  bool MeshResidencyManager::resident( nsol::MorphologyPtr morphology ) const
+  {
+    return _entries.find( morphology ) != _entries.end( );
+  }
+
+  void MeshResidencyManager::touch( nsol::MorphologyPtr morphology )
+  {
+    auto entryIt = _entries.find( morphology );
+    if ( entryIt != _entries.end( ))
+      entryIt->second.lastUse = _frame;
+  }
+
+  void MeshResidencyManager::distance( nsol::MorphologyPtr morphology ,
+                                       float distance_ )
+  {
+    auto entryIt = _entries.find( morphology );
+    if ( entryIt == _entries.end( ))
+      return;
+
+    auto& entry = entryIt->second;
+    if ( entry.distanceFrame != _frame || distance_ < entry.distance )
+    {
+      entry.distance = distance_;
+      entry.distanceFrame = _frame;
+    }
+  }
+
+  std::vector< nsol::MorphologyPtr > MeshResidencyManager::evict(
+    nsol::MorphologyPtr pinned )
+  {
+    std::vector< nsol::MorphologyPtr > evicted;
+    if ( _budget == 0 || _usage <= _budget )
+      return evicted;
+
+    // Candidates sorted by the best ones to evict first.
+    std::vector< std::tuple< float , unsigned long , nsol::MorphologyPtr >>
+      candidates;
+    for ( const auto& entry: _entries )
+    {
+      if ( entry.second.lastUse == _frame || entry.first == pinned )
+        continue;
+
+      const float key = ( _policy == CAMERA_DISTANCE ) ?
+        -entry.second.distance : 0.0f;
+      candidates.emplace_back( key , entry.second.lastUse , entry.first );
+    }
+    std::sort( candidates.begin( ) , candidates.end( ));
+
+    for ( const auto& candidate: candidates )
+    {
+      if ( _usage <= _budget ) break;
+
+      const auto morphology = std::get< 2 >( candidate );
+      remove( morphology );
+      evicted.push_back( morphology );
+      ++_evictions;
+    }
+
+    return evicted;
+  }
+
+  void MeshResidencyManager::clear( )
+  {
+    _entries.clear( );
+    _usage = 0;
+    _reserved = 0;
+    _evictions = 0;
+  }
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_MESHRESIDENCYMANAGER_H_
+#define NEUROTESSMESH_MESHRESIDENCYMANAGER_H_
+
+// NSOL
+#include <nsol/nsol.h>
+
+// C++
+#include <unordered_map>
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class MeshResidencyManager
+   * \brief Keeps the accounting of the neuron meshes resident in GPU memory
+   * and chooses the ones to release when over the memory budget.
+   *
+   * The manager doesn't own the meshes, it only tracks their estimated size,
+   * the last frame they were drawn and their distance to the camera. Meshes
+   * used in the current frame are never chosen for eviction.
+   *
+   */
+  class MeshResidencyManager
+  {
+  public:
+    enum EvictionPolicy
+    {
+      LEAST_RECENTLY_USED = 0,
+      CAMERA_DISTANCE
+    };
+
+    /** \brief MeshResidencyManager class constructor.
+     *
+     */
+    MeshResidencyManager( );
+
+    /** \brief Sets the memory budget.
+     * \param[in] bytes_ Budget in bytes, 0 for no limit.
+     *
+     */
+    void budget( size_t bytes_ );
+
+    /** \brief Returns the memory budget in bytes, 0 if unlimited.
+     *
+     */
+    size_t budget( ) const;
+
+    /** \brief Sets the policy used to choose the meshes to evict.
+     * \param[in] policy_ Eviction policy.
+     *
+     */
+    void policy( EvictionPolicy policy_ );
+
+    /** \brief Returns the current eviction policy.
+     *
+     */
+    EvictionPolicy policy( ) const;
+
+    /** \brief Returns the estimated bytes of the resident meshes and the
+     * reserved memory.
+     *
+     */
+    size_t usage( ) const;
+
+    /** \brief Sets the bytes used by GPU data not registered as resident
+     * meshes, which count against the budget but are never evicted.
+     * \param[in] bytes_ Reserved bytes.
+     *
+     */
+    void reserve( size_t bytes_ );
+
+    /** \brief Returns the number of resident meshes.
+     *
+     */
+    size_t residentMeshes( ) const;
+
+    /** \brief Returns the number of meshes evicted since the last clear.
+     *
+     */
+    unsigned long evictions( ) const;
+
+    /** \brief Returns true if the resident meshes use the whole budget.
+     *
+     */
+    bool full( ) const;
+
+    /** \brief Starts a new frame.
+     *
+     */
+    void nextFrame( );
+
+    /** \brief Registers a resident mesh or updates its size.
+     * \param[in] morphology Morphology of the mesh.
+     * \param[in] bytes Estimated GPU bytes of the mesh.
+     *
+     */
+    void insert( nsol::MorphologyPtr morphology , size_t bytes );
+
+    /** \brief Unregisters a mesh.
+     * \param[in] morphology Morphology of the mesh.
+     *
+     */
+    void remove( nsol::MorphologyPtr morphology );
+
+    /** \brief Returns true if the mesh of the morphology is resident.
+     * \param[in] morphology Morphology of the mesh.
+     *
+     */
+    bool resident( nsol::MorphologyPtr morphology ) const;
+
+    /** \brief Marks the mesh as drawn in the current frame.
+     * \param[in] morphology Morphology of the mesh.
+     *
+     */
+    void touch( nsol::MorphologyPtr morphology );
+
+    /** \brief Updates the camera distance of the mesh. The closest instance
+     * is kept when several neurons share the same morphology.
+     * \param[in] morphology Morphology of the mesh.
+     * \param[in] distance Distance to the camera.
+     *
+     */
+    void distance( nsol::MorphologyPtr morphology , float distance );
+
+    /** \brief Unregisters the meshes needed to get within the budget and
+     * returns them so the caller can release them.
+     * \param[in] pinned Morphology whose mesh must not be evicted.
+     * \returns Morphologies of the evicted meshes.
+     *
+     */
+    std::vector< nsol::MorphologyPtr > evict(
+      nsol::MorphologyPtr pinned = nullptr );
+
+    /** \brief Removes all the registered meshes and the reserved memory,
+     * and resets the counters.
+     *
+     */
+    void clear( );
+
+  protected:
+
+    struct Entry
+    {
+      size_t bytes;
+      unsigned long lastUse;
+      unsigned long distanceFrame;
+      float distance;
+    };
+
+    //! Resident meshes
+    std::unordered_map< nsol::MorphologyPtr , Entry > _entries;
+
+    //! Memory budget in bytes, 0 if unlimited
+    size_t _budget;
+
+    //! Estimated bytes of the resident meshes and the reserved memory
+    size_t _usage;
+
+    //! Bytes reserved for data not registered as meshes
+    size_t _reserved;
+
+    //! Eviction policy
+    EvictionPolicy _policy;
+
+    //! Current frame
+    unsigned long _frame;
+
+    //! Number of evicted meshes
+    unsigned long _evictions;
+  };
+}
+
+#endif /* NEUROTESSMESH_MESHRESIDENCYMANAGER_H_ */
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NeuronBounds.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+  /** \brief Min/max reduction of a float array, written as a plain loop over
+   * contiguous data so the compiler can vectorize it.
+   *
+   */
+  void reduce( const std::vector< float >& minimums ,
+               const std::vector< float >& maximums ,
+               float& minimum , float& maximum )
+  {
+    float lower = std::numeric_limits< float >::max( );
+    float upper = std::numeric_limits< float >::lowest( );
+    const size_t size = minimums.size( );
+    for ( size_t i = 0; i < size; ++i )
+    {
+      lower = std::min( lower , minimums[ i ]);
+      upper = std::max( upper , maximums[ i ]);
+    }
+    minimum = lower;
+    maximum = upper;
+  }
+}
+
+namespace neurotessmesh
+{
+  bool NeuronBounds::morphologyBounds( nsol::NeuronMorphologyPtr morphology ,
+                                       Eigen::Vector3f& minimum ,
+                                       Eigen::Vector3f& maximum )
+  {
+    minimum = Eigen::Vector3f::Constant( std::numeric_limits< float >::max( ));
+    maximum = Eigen::Vector3f::Constant( std::numeric_limits< float >::lowest( ));
+    bool found = false;
+
+    auto addNodes = [ & ]( const nsol::Nodes& nodes )
+    {
+      for ( const auto node: nodes )
+      {
+        const Eigen::Vector3f point = node->point( );
+        const Eigen::Vector3f radius = Eigen::Vector3f::Constant( node->radius( ));
+        minimum = minimum.cwiseMin( point - radius );
+        maximum = maximum.cwiseMax( point + radius );
+        found = true;
+      }
+    };
+
+    const auto soma = morphology->soma( );
+    if ( soma )
+    {
+      const Eigen::Vector3f center = soma->center( );
+      const Eigen::Vector3f radius = Eigen::Vector3f::Constant( soma->maxRadius( ));
+      minimum = minimum.cwiseMin( center - radius );
+      maximum = maximum.cwiseMax( center + radius );
+      found = true;
+      addNodes( soma->nodes( ));
+    }
+
+    std::vector< nsol::NeuronMorphologySectionPtr > stack;
+    for ( const auto neurite: morphology->neurites( ))
+    {
+      if ( neurite->firstSection( ))
+        stack.push_back( neurite->firstSection( ));
+
+      while ( !stack.empty( ))
+      {
+        const auto section = stack.back( );
+        stack.pop_back( );
+
+        addNodes( section->nodes( ));
+        for ( const auto child: section->children( ))
+        {
+          const auto childSection =
+            dynamic_cast< nsol::NeuronMorphologySectionPtr >( child );
+          if ( childSection )
+            stack.push_back( childSection );
+        }
+      }
+    }
+
+    return found;
+  }
+
+  void NeuronBounds::build( const nsol::NeuronsMap& neurons )
+  {
+    clear( );
+    _ids.reserve( neurons.size( ));
+    for ( auto array: { &_minX , &_minY , &_minZ , &_maxX , &_maxY , &_maxZ })
+      array->reserve( neurons.size( ));
+
+    // Morphologies are shared between neurons, their local boxes are only
+    // computed once.
+    struct LocalBounds
+    {
+      bool valid;
+      Eigen::Vector3f center;
+      Eigen::Vector3f extent;
+    };
+    std::unordered_map< nsol::NeuronMorphologyPtr , LocalBounds > local;
+
+    for ( const auto& neuronIt: neurons )
+    {
+      const auto neuron = neuronIt.second;
+      const auto morphology = neuron->morphology( );
+      if ( !morphology )
+        continue;
+
+      auto localIt = local.find( morphology );
+      if ( localIt == local.end( ))
+      {
+        Eigen::Vector3f minimum , maximum;
+        LocalBounds bounds;
+        bounds.valid = morphologyBounds( morphology , minimum , maximum );
+        bounds.center = ( minimum + maximum ) * 0.5f;
+        bounds.extent = ( maximum - minimum ) * 0.5f;
+        localIt = local.emplace( morphology , bounds ).first;
+      }
+      if ( !localIt->second.valid )
+        continue;
+
+      // Transformed box of the local box: the center is transformed and the
+      // extent projected with the absolute rotation and scale.
+      const Eigen::Matrix4f transform = neuron->transform( );
+      const Eigen::Vector3f center =
+        transform.block< 3 , 3 >( 0 , 0 ) * localIt->second.center +
+        transform.block< 3 , 1 >( 0 , 3 );
+      const Eigen::Vector3f extent =
+        transform.block< 3 , 3 >( 0 , 0 ).cwiseAbs( ) * localIt->second.extent;
+
+      _ids.push_back( neuronIt.first );
+      _minX.push_back( center.x( ) - extent.x( ));
+      _minY.push_back( center.y( ) - extent.y( ));
+      _minZ.push_back( center.z( ) - extent.z( ));
+      _maxX.push_back( center.x( ) + extent.x( ));
+      _maxY.push_back( center.y( ) + extent.y( ));
+      _maxZ.push_back( center.z( ) + extent.z( ));
+    }
+  }
+
+  void NeuronBounds::clear( )
+  {
+    _ids.clear( );
+    for ( auto array: { &_minX , &_minY , &_minZ , &_maxX , &_maxY , &_maxZ })
+      array->clear( );
+  }
+
+  long NeuronBounds::index( unsigned int id ) const
+  {
+    const auto it = std::lower_bound( _ids.begin( ) , _ids.end( ) , id );
+    if ( it == _ids.end( ) || *it != id )
+      return -1;
+    return static_cast< long >( it - _ids.begin( ));
+  }
+
+  nlgeometry::AxisAlignedBoundingBox NeuronBounds::bounds( ) const
+  {
+    Eigen::Vector3f minimum , maximum;
+    if ( !extent( minimum , maximum ))
+      return { Eigen::Vector3f::Zero( ) , Eigen::Vector3f::Zero( ) };
+
+    return { minimum , maximum };
+  }
+
+  bool NeuronBounds::extent( Eigen::Vector3f& minimum ,
+                             Eigen::Vector3f& maximum ) const
+  {
+    if ( _ids.empty( ))
+      return false;
+
+    reduce( _minX , _maxX , minimum.x( ) , maximum.x( ));
+    reduce( _minY , _maxY , minimum.y( ) , maximum.y( ));
+    reduce( _minZ , _maxZ , minimum.z( ) , maximum.z( ));
+    return true;
+  }
+
+  nlgeometry::AxisAlignedBoundingBox
+  NeuronBounds::bounds( const std::vector< unsigned int >& ids ) const
+  {
+    Eigen::Vector3f minimum =
+      Eigen::Vector3f::Constant( std::numeric_limits< float >::max( ));
+    Eigen::Vector3f maximum =
+      Eigen::Vector3f::Constant( std::numeric_limits< float >::lowest( ));
+    bool found = false;
+
+    for ( const auto id: ids )
+    {
+      const auto i = index( id );
+      if ( i < 0 )
+        continue;
+
+      minimum = minimum.cwiseMin( this->minimum( static_cast< size_t >( i )));
+      maximum = maximum.cwiseMax( this->maximum( static_cast< size_t >( i )));
+      found = true;
+    }
+
+    if ( !found )
+      return { Eigen::Vector3f::Zero( ) , Eigen::Vector3f::Zero( ) };
+
+    return { minimum , maximum };
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_NEURONBOUNDS_H_
+#define NEUROTESSMESH_NEURONBOUNDS_H_
+
+// NSOL
+#include <nsol/nsol.h>
+
+// neurolots
+#include <nlgeometry/nlgeometry.h>
+
+// C++
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class NeuronBounds
+   * \brief World space axis aligned bounding boxes of the neurons, computed
+   * once from the full morphologies (soma and neurites) and stored as flat
+   * arrays sorted by neuron id.
+   *
+   */
+  class NeuronBounds
+  {
+  public:
+    /** \brief Computes the bounding boxes of the given neurons.
+     * \param[in] neurons Dataset neurons.
+     *
+     */
+    void build( const nsol::NeuronsMap& neurons );
+
+    /** \brief Removes all the bounding boxes.
+     *
+     */
+    void clear( );
+
+    /** \brief Returns the number of neurons with a bounding box.
+     *
+     */
+    size_t size( ) const
+    { return _ids.size( ); }
+
+    /** \brief Returns the position of the neuron in the arrays or -1 if the
+     * neuron has no bounding box.
+     * \param[in] id Neuron id.
+     *
+     */
+    long index( unsigned int id ) const;
+
+    /** \brief Returns the bounding box of all the neurons.
+     *
+     */
+    nlgeometry::AxisAlignedBoundingBox bounds( ) const;
+
+    /** \brief Returns the corners of the bounding box of all the neurons.
+     * \param[out] minimum Minimum corner.
+     * \param[out] maximum Maximum corner.
+     * \returns false if there are no neurons.
+     *
+     */
+    bool extent( Eigen::Vector3f& minimum , Eigen::Vector3f& maximum ) const;
+
+    /** \brief Returns the bounding box of the given neurons. Unknown ids are
+     * ignored, an empty box at the origin is returned if none is known.
+     * \param[in] ids Neuron ids.
+     *
+     */
+    nlgeometry::AxisAlignedBoundingBox
+    bounds( const std::vector< unsigned int >& ids ) const;
+
+    /** \brief Returns the sorted neuron ids.
+     *
+     */
+    const std::vector< unsigned int >& ids( ) const
+    { return _ids; }
+
+    /** \brief Returns the minimum corner of the box at the given index.
+     *
+     */
+    Eigen::Vector3f minimum( size_t index ) const
+    { return Eigen::Vector3f( _minX[ index ] , _minY[ index ] , _minZ[ index ]); }
+
+    /** \brief Returns the maximum corner of the box at the given index.
+     *
+     */
+    Eigen::Vector3f maximum( size_t index ) const
+    { return Eigen::Vector3f( _maxX[ index ] , _maxY[ index ] , _maxZ[ index ]); }
+
+    /** \brief Computes the morphology bounding box in its local coordinates,
+     * taking into account the node radii.
+     * \param[in] morphology Morphology.
+     * \param[out] minimum Minimum corner.
+     * \param[out] maximum Maximum corner.
+     * \returns false if the morphology has no nodes.
+     *
+     */
+    static bool morphologyBounds( nsol::NeuronMorphologyPtr morphology ,
+                                  Eigen::Vector3f& minimum ,
+                                  Eigen::Vector3f& maximum );
+
+  private:
+    std::vector< unsigned int > _ids;
+    std::vector< float > _minX;
+    std::vector< float > _minY;
+    std::vector< float > _minZ;
+    std::vector< float > _maxX;
+    std::vector< float > _maxY;
+    std::vector< float > _maxZ;
+  };
+}
+
+#endif /* NEUROTESSMESH_NEURONBOUNDS_H_ */
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NeuronIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+  std::string trim( const std::string& text )
+  {
+    const auto first = text.find_first_not_of( " \t" );
+    if ( first == std::string::npos )
+      return std::string( );
+
+    const auto last = text.find_last_not_of( " \t" );
+    return text.substr( first , last - first + 1 );
+  }
+
+  std::string upper( std::string text )
+  {
+    std::transform( text.begin( ) , text.end( ) , text.begin( ) ,
+                    []( unsigned char c ){ return std::toupper( c ); });
+    return text;
+  }
+
+  std::vector< std::string > split( const std::string& text , char separator )
+  {
+    std::vector< std::string > parts;
+    std::string::size_type begin = 0;
+    while ( true )
+    {
+      const auto end = text.find( separator , begin );
+      parts.push_back( trim( text.substr( begin , end - begin )));
+      if ( end == std::string::npos ) break;
+      begin = end + 1;
+    }
+    return parts;
+  }
+
+  /** \brief Parses "n" or "n-m" into an inclusive range.
+   * \returns false if the text isn't a number or a range.
+   *
+   */
+  bool parseRange( const std::string& text , long& first , long& last )
+  {
+    if ( text.empty( ) || !std::isdigit( static_cast< unsigned char >( text[ 0 ])))
+      return false;
+
+    size_t pos = 0;
+    first = std::stol( text , &pos );
+    last = first;
+    const auto rest = trim( text.substr( pos ));
+    if ( rest.empty( ))
+      return true;
+
+    if ( rest[ 0 ] != '-' )
+      return false;
+
+    const auto second = trim( rest.substr( 1 ));
+    if ( second.empty( ) ||
+         !std::isdigit( static_cast< unsigned char >( second[ 0 ])))
+      return false;
+
+    last = std::stol( second , &pos );
+    if ( pos != second.size( ))
+      return false;
+
+    if ( last < first )
+      std::swap( first , last );
+    return true;
+  }
+
+  std::vector< unsigned int > intersection( const std::vector< unsigned int >& a ,
+                                            const std::vector< unsigned int >& b )
+  {
+    std::vector< unsigned int > result;
+    result.reserve( std::min( a.size( ) , b.size( )));
+    std::set_intersection( a.begin( ) , a.end( ) , b.begin( ) , b.end( ) ,
+                           std::back_inserter( result ));
+    return result;
+  }
+
+  std::vector< unsigned int > merge( const std::vector< unsigned int >& a ,
+                                     const std::vector< unsigned int >& b )
+  {
+    std::vector< unsigned int > result;
+    result.reserve( a.size( ) + b.size( ));
+    std::set_union( a.begin( ) , a.end( ) , b.begin( ) , b.end( ) ,
+                    std::back_inserter( result ));
+    return result;
+  }
+}
+
+namespace neurotessmesh
+{
+  NeuronIndex::NeuronIndex( )
+  { }
+
+  void NeuronIndex::build( const nsol::NeuronsMap& neurons )
+  {
+    clear( );
+
+    _ids.reserve( neurons.size( ));
+    for ( const auto& neuronIt: neurons )
+    {
+      const auto id = neuronIt.first;
+      const auto neuron = neuronIt.second;
+
+      _ids.push_back( id );
+      _types[ static_cast< int >( neuron->morphologicalType( ))].push_back( id );
+      _layers[ static_cast< int >( neuron->layer( ))].push_back( id );
+      _functions[ static_cast< int >( neuron->functionalType( ))].push_back( id );
+    }
+
+    std::sort( _ids.begin( ) , _ids.end( ));
+    for ( auto postings: { &_types , &_layers , &_functions })
+    {
+      for ( auto& list: *postings )
+        std::sort( list.second.begin( ) , list.second.end( ));
+    }
+
+    for ( const auto& type: _types )
+      _typeNames[ upper( nsol::Neuron::typeToString(
+        static_cast< nsol::Neuron::TMorphologicalType >( type.first )))] =
+        type.first;
+
+    for ( const auto& function: _functions )
+      _functionNames[ upper( nsol::Neuron::functionToString(
+        static_cast< nsol::Neuron::TFunctionalType >( function.first )))] =
+        function.first;
+  }
+
+  void NeuronIndex::clear( )
+  {
+    _ids.clear( );
+    _types.clear( );
+    _layers.clear( );
+    _functions.clear( );
+    _typeNames.clear( );
+    _functionNames.clear( );
+  }
+
+  const NeuronIndex::Ids& NeuronIndex::ids( ) const
+  {
+    return _ids;
+  }
+
+  NeuronIndex::Ids NeuronIndex::query( const std::string& query_ ) const
+  {
+    Ids result;
+    for ( const auto& alternative: split( query_ , '|' ))
+    {
+      if ( alternative.empty( ))
+        throw std::runtime_error( "Empty expression in query" );
+
+      auto terms = split( alternative , '&' );
+
+      // Intersect starting from the smallest posting list.
+      std::vector< Ids > matches;
+      matches.reserve( terms.size( ));
+      for ( const auto& text: terms )
+      {
+        if ( text.empty( ))
+          throw std::runtime_error( "Empty term in query" );
+        matches.push_back( term( text ));
+      }
+      std::sort( matches.begin( ) , matches.end( ) ,
+                 []( const Ids& a , const Ids& b ){ return a.size( ) < b.size( ); });
+
+      Ids partial = matches.front( );
+      for ( size_t i = 1; i < matches.size( ) && !partial.empty( ); ++i )
+        partial = intersection( partial , matches[ i ]);
+
+      result = result.empty( ) ? partial : merge( result , partial );
+    }
+
+    return result;
+  }
+
+  NeuronIndex::Ids NeuronIndex::term( const std::string& text ) const
+  {
+    long first , last;
+    if ( parseRange( text , first , last ))
+    {
+      const auto begin = std::lower_bound( _ids.begin( ) , _ids.end( ) ,
+        static_cast< unsigned int >( std::max( first , 0L )));
+      const auto end = std::upper_bound( begin , _ids.end( ) ,
+        static_cast< unsigned int >( std::max( last , 0L )));
+      return Ids( begin , end );
+    }
+
+    const auto space = text.find_first_of( " \t" );
+    const auto keyword = upper( text.substr( 0 , space ));
+    const auto argument = space == std::string::npos ?
+      std::string( ) : trim( text.substr( space ));
+
+    if ( keyword == "LAYER" )
+    {
+      if ( !parseRange( argument , first , last ))
+        throw std::runtime_error( "Invalid layer in query: " + text );
+      return postingsRange( _layers , static_cast< int >( first ) ,
+                            static_cast< int >( last ));
+    }
+
+    const auto name = upper(( keyword == "TYPE" || keyword == "FUNCTION" ) ?
+                            argument : text );
+
+    if ( keyword != "FUNCTION" )
+    {
+      const auto type = _typeNames.find( name );
+      if ( type != _typeNames.end( ))
+        return _types.at( type->second );
+    }
+
+    if ( keyword != "TYPE" )
+    {
+      const auto function = _functionNames.find( name );
+      if ( function != _functionNames.end( ))
+        return _functions.at( function->second );
+    }
+
+    throw std::runtime_error( "Unknown term in query: " + text );
+  }
+
+  NeuronIndex::Ids NeuronIndex::postingsRange(
+    const std::map< int , Ids >& postings , int first , int last )
+  {
+    Ids result;
+    const auto end = postings.upper_bound( last );
+    for ( auto it = postings.lower_bound( first ); it != end; ++it )
+      result = result.empty( ) ? it->second : merge( result , it->second );
+    return result;
+  }
+}
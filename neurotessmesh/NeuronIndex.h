@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_NEURONINDEX_H_
+#define NEUROTESSMESH_NEURONINDEX_H_
+
+// NSOL
+#include <nsol/nsol.h>
+
+// C++
+#include <map>
+#include <string>
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class NeuronIndex
+   * \brief Prebuilt indices of the dataset neurons to answer filter queries
+   * without traversing the dataset.
+   *
+   * Queries are made of terms joined by '&' (intersection) and '|' (union,
+   * lower precedence). A term can be:
+   *  - a neuron id "1000" or an id range "1000-2000".
+   *  - a layer "layer 5" or a layer range "layer 2-4".
+   *  - a morphological type "PYRAMIDAL", optionally prefixed by "type".
+   *  - a functional type "EXCITATORY", optionally prefixed by "function".
+   * Names are case insensitive.
+   *
+   */
+  class NeuronIndex
+  {
+  public:
+    typedef std::vector< unsigned int > Ids;
+
+    /** \brief NeuronIndex class constructor.
+     *
+     */
+    NeuronIndex( );
+
+    /** \brief Builds the indices of the given neurons.
+     * \param[in] neurons Dataset neurons.
+     *
+     */
+    void build( const nsol::NeuronsMap& neurons );
+
+    /** \brief Removes all the indices.
+     *
+     */
+    void clear( );
+
+    /** \brief Returns all the indexed neuron ids, sorted.
+     *
+     */
+    const Ids& ids( ) const;
+
+    /** \brief Returns the sorted ids of the neurons matching the query.
+     * \param[in] query Query text.
+     * Throws std::runtime_error if the query can't be parsed.
+     *
+     */
+    Ids query( const std::string& query ) const;
+
+  protected:
+
+    /** \brief Returns the sorted ids matching a single term.
+     * \param[in] term Trimmed term text.
+     *
+     */
+    Ids term( const std::string& term ) const;
+
+    /** \brief Returns the ids of the postings lists in the given key range.
+     * \param[in] postings Postings lists.
+     * \param[in] first First key.
+     * \param[in] last Last key.
+     *
+     */
+    static Ids postingsRange( const std::map< int , Ids >& postings ,
+                              int first , int last );
+
+    //! Sorted neuron ids
+    Ids _ids;
+
+    //! Sorted neuron ids of each morphological type, layer and functional type
+    std::map< int , Ids > _types;
+    std::map< int , Ids > _layers;
+    std::map< int , Ids > _functions;
+
+    //! Upper case names of the indexed morphological and functional types
+    std::map< std::string , int > _typeNames;
+    std::map< std::string , int > _functionNames;
+  };
+}
+
+#endif /* NEUROTESSMESH_NEURONINDEX_H_ */
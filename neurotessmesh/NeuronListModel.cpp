@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Project
+#include "NeuronListModel.h"
+#include <neurotessmesh/Scene.h>
+
+// Qt
+#include <QColor>
+
+// C++
+#include <algorithm>
+
+namespace neurotessmesh
+{
+  NeuronListModel::NeuronListModel( QObject* parent )
+    : QAbstractListModel( parent )
+    , m_scene{ nullptr }
+    , m_additionalInfo{ false }
+  { }
+
+  void NeuronListModel::setScene( std::shared_ptr< Scene > scene )
+  {
+    beginResetModel( );
+
+    m_scene = scene;
+    m_ids.clear( );
+
+    if ( m_scene )
+    {
+      m_ids.reserve( m_scene->neurons( ).size( ));
+      for ( const auto& neuron: m_scene->neurons( ))
+        m_ids.push_back( neuron.first );
+
+      std::sort( m_ids.begin( ) , m_ids.end( ));
+    }
+    updateColorTypes( );
+
+    endResetModel( );
+  }
+
+  void NeuronListModel::setFilter( const std::vector< unsigned int >& ids )
+  {
+    beginResetModel( );
+    m_ids = ids;
+    updateColorTypes( );
+    endResetModel( );
+  }
+
+  void NeuronListModel::clearFilter( )
+  {
+    setScene( m_scene );
+  }
+
+  void NeuronListModel::showAdditionalInformation( bool enabled )
+  {
+    if ( m_additionalInfo == enabled )
+      return;
+
+    m_additionalInfo = enabled;
+
+    if ( !m_ids.empty( ))
+      emit dataChanged( index( 0 ) , index( static_cast< int >( m_ids.size( )) - 1 ) ,
+                        { Qt::DisplayRole } );
+  }
+
+  void NeuronListModel::colorsChanged( )
+  {
+    if ( !m_ids.empty( ))
+      emitColorsChanged( 0 , static_cast< int >( m_ids.size( )) - 1 );
+  }
+
+  void NeuronListModel::colorsChanged( int mode , int type )
+  {
+    if ( !m_scene )
+      return;
+
+    // Rows whose type color is black show the selection colors, they are
+    // found by type as well.
+    switch ( mode )
+    {
+      case Scene::MORPHOLOGY:
+        emitColorsChanged( [ this , type ]( size_t row )
+                           { return m_types[ row ].morphology == type; });
+        break;
+      case Scene::LAYER:
+        emitColorsChanged( [ this , type ]( size_t row )
+                           { return m_types[ row ].layer == type; });
+        break;
+      case Scene::FUNCTION:
+        emitColorsChanged( [ this , type ]( size_t row )
+                           { return m_types[ row ].function == type; });
+        break;
+      case Scene::SELECTION:
+      default:
+      {
+        const auto& selected = m_scene->selectedIndices( );
+        emitColorsChanged( [ this , type , &selected ]( size_t row )
+          {
+            const bool isSelected =
+              selected.find( m_ids[ row ]) != selected.end( );
+            return static_cast< int >( isSelected ) == type;
+          });
+        break;
+      }
+    }
+  }
+
+  int NeuronListModel::row( unsigned int id ) const
+  {
+    const auto it = std::lower_bound( m_ids.cbegin( ) , m_ids.cend( ) , id );
+    if ( it == m_ids.cend( ) || *it != id )
+      return -1;
+
+    return static_cast< int >( std::distance( m_ids.cbegin( ) , it ));
+  }
+
+  int NeuronListModel::rowCount( const QModelIndex& parent ) const
+  {
+    return parent.isValid( ) ? 0 : static_cast< int >( m_ids.size( ));
+  }
+
+  QVariant NeuronListModel::data( const QModelIndex& index , int role ) const
+  {
+    if ( !m_scene || !index.isValid( ) ||
+         index.row( ) >= static_cast< int >( m_ids.size( )))
+      return QVariant( );
+
+    const auto id = m_ids[ index.row( )];
+
+    auto neuronColor = [ this , id ]( )
+    {
+      const auto color = m_scene->neuronColor( id );
+      return QColor::fromRgbF( color[ 0 ] , color[ 1 ] , color[ 2 ] );
+    };
+
+    switch ( role )
+    {
+      case Qt::DisplayRole:
+      {
+        const auto neuronIt = m_scene->neurons( ).find( id );
+        if ( neuronIt == m_scene->neurons( ).cend( ))
+          return QString::number( id );
+
+        const auto type = neuronIt->second->morphologicalType( );
+        const auto function = neuronIt->second->functionalType( );
+        const auto layer = neuronIt->second->layer( );
+
+        auto text = QString::fromStdString( nsol::Neuron::typeToString( type ));
+        if ( m_additionalInfo && ( function + layer > 0 ))
+        {
+          QString layerText , functionText , separator;
+          if ( function > 0 )
+            functionText = QString::fromStdString( nsol::Neuron::functionToString( function ));
+          if ( layer > 0 )
+            layerText = QString( "layer " ) + QString::number( static_cast< unsigned int >( layer ));
+          if ( function > 0 && layer > 0 )
+            separator = ", ";
+
+          text += QString( " (%1%2%3)" ).arg( functionText ).arg( separator ).arg( layerText );
+        }
+
+        return QString::number( id ) + " " + text;
+      }
+      case Qt::BackgroundRole:
+        return neuronColor( );
+      case Qt::ForegroundRole:
+      {
+        // Try to return a color with a lot of contrast with the background.
+        const auto color = neuronColor( );
+        const auto a = 1 - ( 0.299 * color.redF( ) + 0.587 * color.greenF( ) + 0.114 * color.blueF( ));
+        return ( a <= 0.3 ) ? QColor( 0 , 0 , 0 ) : QColor( 255 , 255 , 255 );
+      }
+      case ID_ROLE:
+        return id;
+      case COLOR_ROLE:
+        return neuronColor( ).name( );
+      case TEXT_ROLE:
+      {
+        const auto neuronIt = m_scene->neurons( ).find( id );
+        if ( neuronIt == m_scene->neurons( ).cend( ))
+          return QVariant( );
+        return static_cast< int >( neuronIt->second->morphologicalType( ));
+      }
+      default:
+        break;
+    }
+
+    return QVariant( );
+  }
+
+  void NeuronListModel::updateColorTypes( )
+  {
+    m_types.clear( );
+    if ( !m_scene )
+      return;
+
+    m_types.reserve( m_ids.size( ));
+    for ( const auto id: m_ids )
+    {
+      const auto neuronIt = m_scene->neurons( ).find( id );
+      if ( neuronIt == m_scene->neurons( ).cend( ))
+      {
+        m_types.push_back( ColorTypes{ -1 , -1 , -1 });
+        continue;
+      }
+
+      const auto neuron = neuronIt->second;
+      m_types.push_back( ColorTypes{
+        static_cast< int >( neuron->morphologicalType( )) ,
+        static_cast< int >( neuron->layer( )) ,
+        static_cast< int >( neuron->functionalType( ))});
+    }
+  }
+
+  void NeuronListModel::emitColorsChanged(
+    const std::function< bool( size_t ) >& affected )
+  {
+    // Consecutive affected rows are notified as a single range.
+    int first = -1;
+    for ( size_t row = 0; row < m_ids.size( ); ++row )
+    {
+      if ( affected( row ))
+      {
+        if ( first == -1 ) first = static_cast< int >( row );
+      }
+      else if ( first != -1 )
+      {
+        emitColorsChanged( first , static_cast< int >( row ) - 1 );
+        first = -1;
+      }
+    }
+
+    if ( first != -1 )
+      emitColorsChanged( first , static_cast< int >( m_ids.size( )) - 1 );
+  }
+
+  void NeuronListModel::emitColorsChanged( int first , int last )
+  {
+    emit dataChanged( index( first ) , index( last ) ,
+                      { Qt::BackgroundRole , Qt::ForegroundRole , COLOR_ROLE } );
+  }
+}
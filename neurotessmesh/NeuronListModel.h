@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_NEURONLISTMODEL_H_
+#define NEUROTESSMESH_NEURONLISTMODEL_H_
+
+// Qt
+#include <QAbstractListModel>
+
+// C++
+#include <functional>
+#include <memory>
+#include <vector>
+
+constexpr int ID_ROLE = Qt::UserRole +1;
+constexpr int COLOR_ROLE = Qt::UserRole +2;
+constexpr int TEXT_ROLE = Qt::UserRole +3;
+
+namespace neurotessmesh
+{
+  class Scene;
+
+  /** \class NeuronListModel
+   * \brief List model of the scene neurons sorted by id. Rows only store the
+   * neuron id, texts and colors are computed from the scene when the view
+   * requests them.
+   *
+   */
+  class NeuronListModel
+    : public QAbstractListModel
+  {
+  Q_OBJECT
+  public:
+    /** \brief NeuronListModel class constructor.
+     * \param[in] parent Raw pointer of the parent object.
+     *
+     */
+    explicit NeuronListModel( QObject* parent = nullptr );
+
+    /** \brief NeuronListModel class virtual destructor.
+     *
+     */
+    virtual ~NeuronListModel( )
+    { };
+
+    /** \brief Sets the scene whose neurons are listed.
+     * \param[in] scene Scene or nullptr to empty the list.
+     *
+     */
+    void setScene( std::shared_ptr< Scene > scene );
+
+    /** \brief Lists only the given neurons.
+     * \param[in] ids Sorted ids of the neurons to list.
+     *
+     */
+    void setFilter( const std::vector< unsigned int >& ids );
+
+    /** \brief Lists all the scene neurons.
+     *
+     */
+    void clearFilter( );
+
+    /** \brief Enables or disables the layer and function in the row texts.
+     * \param[in] enabled True to show the additional information.
+     *
+     */
+    void showAdditionalInformation( bool enabled );
+
+    /** \brief Notifies the views that the colors of every row have changed.
+     *
+     */
+    void colorsChanged( );
+
+    /** \brief Notifies the views that the colors of the neurons of a type
+     * have changed.
+     * \param[in] mode Scene::TColoringMode the type belongs to.
+     * \param[in] type Selection state, morphological type, layer or
+     * functional type, as given to Scene::setColor.
+     *
+     */
+    void colorsChanged( int mode , int type );
+
+    /** \brief Returns the row of the given neuron id or -1 if not listed.
+     * \param[in] id Neuron id.
+     *
+     */
+    int row( unsigned int id ) const;
+
+    virtual int rowCount( const QModelIndex& parent = QModelIndex( )) const override;
+
+    virtual QVariant data( const QModelIndex& index , int role = Qt::DisplayRole ) const override;
+
+  private:
+    //! Neuron values the colors depend on, see Scene::TColoringMode
+    struct ColorTypes
+    {
+      int morphology;
+      int layer;
+      int function;
+    };
+
+    /** \brief Stores the color types of the listed neurons.
+     *
+     */
+    void updateColorTypes( );
+
+    /** \brief Emits dataChanged for the rows matching the given predicate,
+     * consecutive rows as a single range.
+     * \param[in] affected Returns true for the changed rows.
+     *
+     */
+    void emitColorsChanged( const std::function< bool( size_t ) >& affected );
+
+    /** \brief Emits dataChanged for the given rows range and color roles.
+     * \param[in] first First row.
+     * \param[in] last Last row.
+     *
+     */
+    void emitColorsChanged( int first , int last );
+
+    std::shared_ptr< Scene > m_scene;  /** listed scene.          */
+    std::vector< unsigned int > m_ids; /** neuron ids, sorted.    */
+    std::vector< ColorTypes > m_types; /** color types of the ids. */
+    bool m_additionalInfo;             /** true to show layer and function. */
+  };
+}
+
+#endif /* NEUROTESSMESH_NEURONLISTMODEL_H_ */
@@ -0,0 +1,516 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NeuronPicker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  /** \brief Slab test of a ray against a box.
+   * \returns the entry distance or infinity if there's no intersection.
+   *
+   */
+  float rayBox( const Eigen::Vector3f& origin ,
+                const Eigen::Vector3f& inverseDirection ,
+                const Eigen::Vector3f& minimum ,
+                const Eigen::Vector3f& maximum )
+  {
+    const Eigen::Array3f t0 = ( minimum - origin ).array( ) *
+                              inverseDirection.array( );
+    const Eigen::Array3f t1 = ( maximum - origin ).array( ) *
+                              inverseDirection.array( );
+    const float enter = std::max( t0.min( t1 ).maxCoeff( ) , 0.0f );
+    const float exit = t0.max( t1 ).minCoeff( );
+    return enter <= exit ? enter : std::numeric_limits< float >::infinity( );
+  }
+
+  Eigen::Vector3f inverse( const Eigen::Vector3f& direction )
+  {
+    // Zero components become huge values, keeping the slab test valid.
+    auto safe = []( float value )
+    {
+      return std::fabs( value ) > 1e-12f ? 1.0f / value :
+        std::copysign( 1e12f , value );
+    };
+    return Eigen::Vector3f( safe( direction.x( )) , safe( direction.y( )) ,
+                            safe( direction.z( )));
+  }
+}
+
+namespace neurotessmesh
+{
+  void NeuronPicker::build( const nsol::NeuronsMap& neurons ,
+                            const NeuronBounds& bounds )
+  {
+    clear( );
+
+    const auto size = bounds.size( );
+    _ids = bounds.ids( );
+    _morphologies.reserve( size );
+    _inverseTransforms.reserve( size );
+    _minimums.reserve( size );
+    _maximums.reserve( size );
+    _somata.reserve( size );
+    for ( size_t i = 0; i < size; ++i )
+    {
+      const auto neuron = neurons.at( _ids[ i ]);
+      _morphologies.push_back( neuron->morphology( ));
+      _inverseTransforms.push_back( Eigen::Matrix4f( neuron->transform( )).inverse( ));
+      _minimums.push_back( bounds.minimum( i ));
+      _maximums.push_back( bounds.maximum( i ));
+
+      const Eigen::Matrix4f transform( neuron->transform( ));
+      const auto morphology = neuron->morphology( );
+      const Eigen::Vector3f center = morphology && morphology->soma( ) ?
+        morphology->soma( )->center( ) : Eigen::Vector3f::Zero( );
+      _somata.push_back(( transform * center.homogeneous( )).head< 3 >( ));
+    }
+
+    if ( size == 0 )
+      return;
+
+    _order.resize( size );
+    for ( unsigned int i = 0; i < size; ++i )
+      _order[ i ] = i;
+
+    _nodes.reserve( 2 * size / LEAF_SIZE + 1 );
+    buildNode( 0 , static_cast< unsigned int >( size ));
+  }
+
+  void NeuronPicker::clear( )
+  {
+    _nodes.clear( );
+    _order.clear( );
+    _ids.clear( );
+    _morphologies.clear( );
+    _inverseTransforms.clear( );
+    _minimums.clear( );
+    _maximums.clear( );
+    _somata.clear( );
+    _geometries.clear( );
+  }
+
+  unsigned int NeuronPicker::buildNode( unsigned int first , unsigned int count )
+  {
+    Eigen::Vector3f minimum =
+      Eigen::Vector3f::Constant( std::numeric_limits< float >::max( ));
+    Eigen::Vector3f maximum =
+      Eigen::Vector3f::Constant( std::numeric_limits< float >::lowest( ));
+    for ( unsigned int i = first; i < first + count; ++i )
+    {
+      minimum = minimum.cwiseMin( _minimums[ _order[ i ]]);
+      maximum = maximum.cwiseMax( _maximums[ _order[ i ]]);
+    }
+    const auto index = static_cast< unsigned int >( _nodes.size( ));
+    _nodes.push_back( Node{ minimum , maximum , first , count , 0 });
+
+    if ( count <= LEAF_SIZE )
+      return index;
+
+    // Median split of the box centers along the longest axis.
+    int axis;
+    ( maximum - minimum ).maxCoeff( &axis );
+    const auto begin = _order.begin( ) + first;
+    const auto middle = begin + count / 2;
+    std::nth_element( begin , middle , begin + count ,
+                      [ this , axis ]( unsigned int a , unsigned int b )
+                      {
+                        return _minimums[ a ][ axis ] + _maximums[ a ][ axis ] <
+                               _minimums[ b ][ axis ] + _maximums[ b ][ axis ];
+                      });
+
+    // Children are stored consecutively, the left one right after.
+    const auto half = count / 2;
+    buildNode( first , half );
+    const auto right = buildNode( first + half , count - half );
+    _nodes[ index ].right = right;
+    return index;
+  }
+
+  bool NeuronPicker::pick( const Eigen::Vector3f& origin ,
+                           const Eigen::Vector3f& direction ,
+                           unsigned int& id , float* distance )
+  {
+    if ( _nodes.empty( ))
+      return false;
+
+    const Eigen::Vector3f inverseDirection = inverse( direction );
+    float best = std::numeric_limits< float >::infinity( );
+    long bestNeuron = -1;
+
+    std::vector< std::pair< float , unsigned int >> stack;
+    stack.emplace_back( rayBox( origin , inverseDirection ,
+                                _nodes[ 0 ].minimum , _nodes[ 0 ].maximum ) , 0 );
+
+    while ( !stack.empty( ))
+    {
+      const auto entry = stack.back( );
+      stack.pop_back( );
+      if ( entry.first >= best )
+        continue;
+
+      const auto& node = _nodes[ entry.second ];
+      if ( node.right == 0 )
+      {
+        for ( unsigned int i = node.first; i < node.first + node.count; ++i )
+        {
+          const auto neuron = _order[ i ];
+          if ( culled( neuron ) || rayBox( origin , inverseDirection , _minimums[ neuron ] ,
+                       _maximums[ neuron ]) >= best )
+            continue;
+
+          float hit;
+          if ( intersectNeuron( neuron , origin , direction , hit ) &&
+               hit < best )
+          {
+            best = hit;
+            bestNeuron = neuron;
+          }
+        }
+        continue;
+      }
+
+      // Pushes the farthest child first so the nearest one is visited next.
+      const unsigned int children[ 2 ] = { entry.second + 1 , node.right };
+      float distances[ 2 ];
+      for ( int i = 0; i < 2; ++i )
+        distances[ i ] = rayBox( origin , inverseDirection ,
+                                 _nodes[ children[ i ]].minimum ,
+                                 _nodes[ children[ i ]].maximum );
+      const int nearest = distances[ 0 ] <= distances[ 1 ] ? 0 : 1;
+      for ( const int i: { 1 - nearest , nearest })
+        if ( distances[ i ] < best )
+          stack.emplace_back( distances[ i ] , children[ i ]);
+    }
+
+    if ( bestNeuron < 0 )
+      return false;
+
+    id = _ids[ static_cast< size_t >( bestNeuron )];
+    if ( distance )
+      *distance = best;
+    return true;
+  }
+
+  std::vector< unsigned int > NeuronPicker::overlapping(
+    const Eigen::Vector3f& minimum , const Eigen::Vector3f& maximum ) const
+  {
+    std::vector< unsigned int > result;
+    if ( _nodes.empty( ))
+      return result;
+
+    auto overlaps = [ &minimum , &maximum ]( const Eigen::Vector3f& otherMin ,
+                                             const Eigen::Vector3f& otherMax )
+    {
+      return ( otherMin.array( ) <= maximum.array( )).all( ) &&
+             ( otherMax.array( ) >= minimum.array( )).all( );
+    };
+
+    std::vector< unsigned int > stack{ 0 };
+    while ( !stack.empty( ))
+    {
+      const auto& node = _nodes[ stack.back( )];
+      const auto index = stack.back( );
+      stack.pop_back( );
+      if ( !overlaps( node.minimum , node.maximum ))
+        continue;
+
+      if ( node.right != 0 )
+      {
+        stack.push_back( index + 1 );
+        stack.push_back( node.right );
+        continue;
+      }
+
+      for ( unsigned int i = node.first; i < node.first + node.count; ++i )
+        if ( overlaps( _minimums[ _order[ i ]] , _maximums[ _order[ i ]]))
+          result.push_back( _ids[ _order[ i ]]);
+    }
+
+    std::sort( result.begin( ) , result.end( ));
+    return result;
+  }
+
+  std::vector< unsigned int > NeuronPicker::inside(
+    const Planes& planes , const SomaFilter& filter ) const
+  {
+    std::vector< unsigned int > result;
+    if ( _nodes.empty( ))
+      return result;
+
+    // Marks the neuron positions, which are sorted by id, instead of
+    // sorting the ids of possibly the whole circuit.
+    std::vector< bool > marked( _ids.size( ) , false );
+
+    // Returns 0 if the box is outside, 1 if it intersects and 2 if inside.
+    auto classify = [ &planes ]( const Eigen::Vector3f& minimum ,
+                                 const Eigen::Vector3f& maximum )
+    {
+      int classification = 2;
+      for ( const auto& plane: planes )
+      {
+        const Eigen::Vector3f normal = plane.head< 3 >( );
+        const Eigen::Vector3f farthest =
+          ( normal.array( ) >= 0.0f ).select( maximum , minimum );
+        if ( normal.dot( farthest ) + plane.w( ) < 0.0f )
+          return 0;
+        const Eigen::Vector3f nearest =
+          ( normal.array( ) >= 0.0f ).select( minimum , maximum );
+        if ( normal.dot( nearest ) + plane.w( ) < 0.0f )
+          classification = 1;
+      }
+      return classification;
+    };
+
+    auto contains = [ &planes ]( const Eigen::Vector3f& point )
+    {
+      for ( const auto& plane: planes )
+        if ( plane.head< 3 >( ).dot( point ) + plane.w( ) < 0.0f )
+          return false;
+      return true;
+    };
+
+    // The somata are inside the neuron bounds, so the neurons of nodes
+    // fully inside the region only need the filter test.
+    std::vector< unsigned int > stack{ 0 };
+    while ( !stack.empty( ))
+    {
+      const auto index = stack.back( );
+      stack.pop_back( );
+
+      const auto& node = _nodes[ index ];
+      const auto classification = classify( node.minimum , node.maximum );
+      if ( classification == 0 )
+        continue;
+
+      if ( classification == 1 && node.right != 0 )
+      {
+        stack.push_back( index + 1 );
+        stack.push_back( node.right );
+        continue;
+      }
+
+      for ( unsigned int i = node.first; i < node.first + node.count; ++i )
+      {
+        const auto& soma = _somata[ _order[ i ]];
+        if ( !culled( _order[ i ]) &&
+             ( classification == 2 || contains( soma )) &&
+            ( !filter || filter( soma )))
+          marked[ _order[ i ]] = true;
+      }
+    }
+
+    for ( size_t i = 0; i < marked.size( ); ++i )
+      if ( marked[ i ])
+        result.push_back( _ids[ i ]);
+    return result;
+  }
+
+  std::vector< bool > NeuronPicker::select( const BoxFilter& filter ) const
+  {
+    std::vector< bool > selected( _ids.size( ) , false );
+    if ( _nodes.empty( ))
+      return selected;
+
+    std::vector< unsigned int > stack{ 0 };
+    while ( !stack.empty( ))
+    {
+      const auto& node = _nodes[ stack.back( )];
+      const auto index = stack.back( );
+      stack.pop_back( );
+      if ( !filter( node.minimum , node.maximum ))
+        continue;
+
+      if ( node.right != 0 )
+      {
+        stack.push_back( index + 1 );
+        stack.push_back( node.right );
+        continue;
+      }
+
+      for ( unsigned int i = node.first; i < node.first + node.count; ++i )
+      {
+        const auto neuron = _order[ i ];
+        selected[ neuron ] = node.count == 1 ||
+                             filter( _minimums[ neuron ] , _maximums[ neuron ]);
+      }
+    }
+    return selected;
+  }
+
+  void NeuronPicker::clippingPlanes( const Planes& planes )
+  {
+    _clippingPlanes = planes;
+  }
+
+  bool NeuronPicker::culled( size_t index ) const
+  {
+    for ( const auto& plane: _clippingPlanes )
+    {
+      const Eigen::Vector3f normal = plane.head< 3 >( );
+      const Eigen::Vector3f farthest =
+        ( normal.array( ) >= 0.0f ).select( _maximums[ index ] ,
+                                            _minimums[ index ]);
+      if ( normal.dot( farthest ) + plane.w( ) < 0.0f )
+        return true;
+    }
+    return false;
+  }
+
+  const Eigen::Vector3f& NeuronPicker::soma( size_t index ) const
+  {
+    return _somata[ index ];
+  }
+
+  const NeuronPicker::MorphologyGeometry&
+  NeuronPicker::geometry( nsol::NeuronMorphologyPtr morphology )
+  {
+    auto it = _geometries.find( morphology );
+    if ( it != _geometries.end( ))
+      return it->second;
+
+    MorphologyGeometry result;
+    const auto soma = morphology->soma( );
+    if ( soma )
+    {
+      const Eigen::Vector3f center = soma->center( );
+      result.segments.push_back(
+        Segment{ center , center , soma->maxRadius( ) , soma->maxRadius( )});
+    }
+
+    std::vector< nsol::NeuronMorphologySectionPtr > stack;
+    for ( const auto neurite: morphology->neurites( ))
+    {
+      if ( neurite->firstSection( ))
+        stack.push_back( neurite->firstSection( ));
+
+      while ( !stack.empty( ))
+      {
+        const auto section = stack.back( );
+        stack.pop_back( );
+
+        const auto& nodes = section->nodes( );
+        for ( size_t i = 1; i < nodes.size( ); ++i )
+          result.segments.push_back( Segment{
+            nodes[ i - 1 ]->point( ) , nodes[ i ]->point( ) ,
+            nodes[ i - 1 ]->radius( ) , nodes[ i ]->radius( )});
+
+        for ( const auto child: section->children( ))
+        {
+          const auto childSection =
+            dynamic_cast< nsol::NeuronMorphologySectionPtr >( child );
+          if ( childSection )
+            stack.push_back( childSection );
+        }
+      }
+    }
+
+    // Consecutive segments are spatially coherent, their boxes are tight.
+    for ( unsigned int first = 0; first < result.segments.size( );
+          first += CHUNK_SIZE )
+    {
+      Chunk chunk;
+      chunk.first = first;
+      chunk.count = std::min( CHUNK_SIZE , static_cast< unsigned int >(
+                                result.segments.size( )) - first );
+      chunk.minimum = Eigen::Vector3f::Constant( std::numeric_limits< float >::max( ));
+      chunk.maximum = Eigen::Vector3f::Constant( std::numeric_limits< float >::lowest( ));
+      for ( unsigned int i = first; i < first + chunk.count; ++i )
+      {
+        const auto& segment = result.segments[ i ];
+        const float radius = std::max( segment.radiusA , segment.radiusB );
+        chunk.minimum = chunk.minimum.cwiseMin(
+          segment.a.cwiseMin( segment.b ) - Eigen::Vector3f::Constant( radius ));
+        chunk.maximum = chunk.maximum.cwiseMax(
+          segment.a.cwiseMax( segment.b ) + Eigen::Vector3f::Constant( radius ));
+      }
+      result.chunks.push_back( chunk );
+    }
+
+    return _geometries.emplace( morphology , std::move( result )).first->second;
+  }
+
+  bool NeuronPicker::intersectNeuron( unsigned int neuron ,
+                                      const Eigen::Vector3f& origin ,
+                                      const Eigen::Vector3f& direction ,
+                                      float& distance )
+  {
+    const auto morphology = _morphologies[ neuron ];
+    if ( !morphology )
+      return false;
+
+    // The ray is moved to the morphology space without normalizing the
+    // direction, so the ray parameter is still the world distance.
+    const auto& inverseTransform = _inverseTransforms[ neuron ];
+    const Eigen::Vector3f localOrigin =
+      ( inverseTransform * origin.homogeneous( )).head< 3 >( );
+    const Eigen::Vector3f localDirection =
+      inverseTransform.block< 3 , 3 >( 0 , 0 ) * direction;
+    const Eigen::Vector3f inverseDirection = inverse( localDirection );
+    const float a = localDirection.squaredNorm( );
+
+    const auto& morphologyGeometry = geometry( morphology );
+    distance = std::numeric_limits< float >::infinity( );
+
+    for ( const auto& chunk: morphologyGeometry.chunks )
+    {
+      if ( rayBox( localOrigin , inverseDirection , chunk.minimum ,
+                   chunk.maximum ) >= distance )
+        continue;
+
+      for ( unsigned int i = chunk.first; i < chunk.first + chunk.count; ++i )
+      {
+        // Closest points between the ray and the segment.
+        const auto& segment = morphologyGeometry.segments[ i ];
+        const Eigen::Vector3f v = segment.b - segment.a;
+        const Eigen::Vector3f w = localOrigin - segment.a;
+        const float b = localDirection.dot( v );
+        const float c = v.squaredNorm( );
+        const float d = localDirection.dot( w );
+        const float e = v.dot( w );
+
+        float t = 0.0f;
+        const float denominator = a * c - b * b;
+        if ( c > 0.0f && denominator > 1e-12f * a * c )
+          t = std::min( 1.0f , std::max( 0.0f , ( a * e - b * d ) / denominator ));
+        else if ( c > 0.0f )
+          t = std::min( 1.0f , std::max( 0.0f , e / c ));
+        const float s = std::max( 0.0f , ( t * b - d ) / a );
+
+        const Eigen::Vector3f closest = localOrigin + s * localDirection -
+                                        ( segment.a + t * v );
+        const float radius = segment.radiusA +
+                             t * ( segment.radiusB - segment.radiusA );
+        const float squaredDistance = closest.squaredNorm( );
+        if ( squaredDistance > radius * radius )
+          continue;
+
+        const float hit = std::max( 0.0f , s - std::sqrt(
+          ( radius * radius - squaredDistance ) / a ));
+        distance = std::min( distance , hit );
+      }
+    }
+
+    return distance < std::numeric_limits< float >::infinity( );
+  }
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_NEURONPICKER_H_
+#define NEUROTESSMESH_NEURONPICKER_H_
+
+// Project
+#include "NeuronBounds.h"
+
+// C++
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class NeuronPicker
+   * \brief Finds the neuron hit by a ray on the CPU.
+   *
+   * A bounding volume hierarchy of the neuron bounding boxes is traversed
+   * nearest first and the candidate neurons are tested against the
+   * segments of their morphologies, approximated by capsules. The segments
+   * of a morphology are extracted the first time one of its neurons is a
+   * candidate and grouped in boxed chunks to discard them quickly.
+   *
+   */
+  class NeuronPicker
+  {
+  public:
+    //! Planes ( a, b, c, d ) with the inside where a*x + b*y + c*z + d >= 0
+    typedef std::vector< Eigen::Vector4f ,
+                         Eigen::aligned_allocator< Eigen::Vector4f >> Planes;
+
+    //! Additional test of the world soma position of a neuron
+    typedef std::function< bool( const Eigen::Vector3f& ) > SomaFilter;
+
+    //! Test of a world bounding box given its minimum and maximum corners
+    typedef std::function< bool( const Eigen::Vector3f& ,
+                                 const Eigen::Vector3f& ) > BoxFilter;
+
+    /** \brief Builds the hierarchy of the given neurons.
+     * \param[in] neurons Dataset neurons.
+     * \param[in] bounds Neuron world bounding boxes.
+     *
+     */
+    void build( const nsol::NeuronsMap& neurons , const NeuronBounds& bounds );
+
+    /** \brief Removes all the neurons.
+     *
+     */
+    void clear( );
+
+    /** \brief Returns the nearest neuron hit by the ray.
+     * \param[in] origin Ray origin in world coordinates.
+     * \param[in] direction Normalized ray direction.
+     * \param[out] id Id of the neuron hit.
+     * \param[out] distance Distance to the hit along the ray, if not null.
+     * \returns true if a neuron was hit.
+     *
+     */
+    bool pick( const Eigen::Vector3f& origin , const Eigen::Vector3f& direction ,
+               unsigned int& id , float* distance = nullptr );
+
+    /** \brief Returns the ids of the neurons whose bounding box intersects
+     * the box.
+     * \param[in] minimum Minimum corner of the box.
+     * \param[in] maximum Maximum corner of the box.
+     *
+     */
+    std::vector< unsigned int > overlapping( const Eigen::Vector3f& minimum ,
+                                             const Eigen::Vector3f& maximum ) const;
+
+    /** \brief Returns the ids of the neurons whose soma is inside the
+     * convex region limited by the planes, usually a frustum.
+     * \param[in] planes Region planes.
+     * \param[in] filter Optional test of the soma positions inside the region.
+     *
+     */
+    std::vector< unsigned int > inside( const Planes& planes ,
+                                        const SomaFilter& filter = nullptr ) const;
+
+    /** \brief Marks the neurons whose bounding box passes the filter. The
+     * hierarchy boxes are tested first, so the filter must also pass for
+     * any box containing a passing one.
+     * \param[in] filter Box test.
+     * \returns flags indexed by the neuron position in the bounds.
+     *
+     */
+    std::vector< bool > select( const BoxFilter& filter ) const;
+
+    /** \brief Sets the clipping planes. Neurons whose bounds are outside any
+     * of them are ignored by the queries.
+     * \param[in] planes Clipping planes, empty to disable clipping.
+     *
+     */
+    void clippingPlanes( const Planes& planes );
+
+    /** \brief Returns true if the neuron at the given position of the
+     * bounds is outside any of the clipping planes.
+     * \param[in] index Neuron position in the bounds.
+     *
+     */
+    bool culled( size_t index ) const;
+
+    /** \brief Returns the world soma position of the neuron at the given
+     * position of the bounds.
+     * \param[in] index Neuron position in the bounds.
+     *
+     */
+    const Eigen::Vector3f& soma( size_t index ) const;
+
+  private:
+    static constexpr unsigned int LEAF_SIZE = 4;
+    static constexpr unsigned int CHUNK_SIZE = 16;
+
+    struct Node
+    {
+      Eigen::Vector3f minimum;
+      Eigen::Vector3f maximum;
+      //! Range of the node neurons in _order
+      unsigned int first;
+      unsigned int count;
+      //! Right child, 0 for leaves. The left child follows the node.
+      unsigned int right;
+    };
+
+    struct Segment
+    {
+      Eigen::Vector3f a;
+      Eigen::Vector3f b;
+      float radiusA;
+      float radiusB;
+    };
+
+    struct Chunk
+    {
+      Eigen::Vector3f minimum;
+      Eigen::Vector3f maximum;
+      unsigned int first;
+      unsigned int count;
+    };
+
+    struct MorphologyGeometry
+    {
+      std::vector< Segment > segments;
+      std::vector< Chunk > chunks;
+    };
+
+    typedef std::vector< Eigen::Matrix4f ,
+                         Eigen::aligned_allocator< Eigen::Matrix4f >> Matrices;
+
+    unsigned int buildNode( unsigned int first , unsigned int count );
+
+    const MorphologyGeometry& geometry( nsol::NeuronMorphologyPtr morphology );
+
+    bool intersectNeuron( unsigned int neuron , const Eigen::Vector3f& origin ,
+                          const Eigen::Vector3f& direction , float& distance );
+
+    std::vector< Node > _nodes;
+    std::vector< unsigned int > _order;
+
+    std::vector< unsigned int > _ids;
+    std::vector< nsol::NeuronMorphologyPtr > _morphologies;
+    Matrices _inverseTransforms;
+    std::vector< Eigen::Vector3f > _minimums;
+    std::vector< Eigen::Vector3f > _maximums;
+    std::vector< Eigen::Vector3f > _somata;
+
+    Planes _clippingPlanes;
+
+    std::unordered_map< nsol::NeuronMorphologyPtr , MorphologyGeometry >
+      _geometries;
+  };
+}
+
+#endif /* NEUROTESSMESH_NEURONPICKER_H_ */
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace neurotessmesh
+{
+  OcclusionCuller::OcclusionCuller( )
+    : _viewProjection( Eigen::Matrix4f::Identity( ))
+    , _valid( false )
+  {
+  }
+
+  std::vector< float >& OcclusionCuller::depthBuffer( unsigned int width ,
+                                                      unsigned int height )
+  {
+    if ( _levels.empty( ))
+      _levels.resize( 1 );
+
+    auto& level = _levels.front( );
+    level.width = width;
+    level.height = height;
+    level.depth.resize( static_cast< size_t >( width ) * height );
+    _valid = false;
+    return level.depth;
+  }
+
+  void OcclusionCuller::update( const Eigen::Matrix4f& viewProjection )
+  {
+    _viewProjection = viewProjection;
+    if ( _levels.empty( ) || _levels.front( ).depth.empty( ))
+    {
+      _valid = false;
+      return;
+    }
+
+    // Each level keeps the farthest depth of the up to 2x2 texels below.
+    size_t index = 0;
+    while ( _levels[ index ].width > 1 || _levels[ index ].height > 1 )
+    {
+      if ( _levels.size( ) <= index + 1 )
+        _levels.resize( index + 2 );
+
+      const auto& source = _levels[ index ];
+      auto& target = _levels[ index + 1 ];
+      target.width = std::max( 1u , ( source.width + 1 ) / 2 );
+      target.height = std::max( 1u , ( source.height + 1 ) / 2 );
+      target.depth.resize( static_cast< size_t >( target.width ) * target.height );
+
+      for ( unsigned int y = 0; y < target.height; ++y )
+      {
+        const auto y0 = static_cast< size_t >( 2 * y ) * source.width;
+        const auto y1 = static_cast< size_t >(
+          std::min( 2 * y + 1 , source.height - 1 )) * source.width;
+        auto output = &target.depth[ static_cast< size_t >( y ) * target.width ];
+
+        for ( unsigned int x = 0; x < target.width; ++x )
+        {
+          const auto x0 = 2 * x;
+          const auto x1 = std::min( 2 * x + 1 , source.width - 1 );
+          output[ x ] = std::max(
+            std::max( source.depth[ y0 + x0 ] , source.depth[ y0 + x1 ]) ,
+            std::max( source.depth[ y1 + x0 ] , source.depth[ y1 + x1 ]));
+        }
+      }
+      ++index;
+    }
+    _levels.resize( index + 1 );
+    _valid = true;
+  }
+
+  void OcclusionCuller::clear( )
+  {
+    _levels.clear( );
+    _valid = false;
+  }
+
+  bool OcclusionCuller::current( const Eigen::Matrix4f& viewProjection ) const
+  {
+    return _valid && _viewProjection == viewProjection;
+  }
+
+  bool OcclusionCuller::occluded( const Eigen::Vector3f& minimum ,
+                                  const Eigen::Vector3f& maximum ) const
+  {
+    if ( !_valid )
+      return false;
+
+    Eigen::Vector3f ndcMinimum =
+      Eigen::Vector3f::Constant( std::numeric_limits< float >::max( ));
+    Eigen::Vector3f ndcMaximum =
+      Eigen::Vector3f::Constant( std::numeric_limits< float >::lowest( ));
+
+    const Eigen::Matrix4f viewProjection( _viewProjection );
+    for ( unsigned int corner = 0; corner < 8; ++corner )
+    {
+      const Eigen::Vector4f point( corner & 1 ? maximum.x( ) : minimum.x( ) ,
+                                   corner & 2 ? maximum.y( ) : minimum.y( ) ,
+                                   corner & 4 ? maximum.z( ) : minimum.z( ) ,
+                                   1.0f );
+      const Eigen::Vector4f clip = viewProjection * point;
+
+      // Boxes crossing the near plane are always visible
+      if ( clip.w( ) <= 0.0f || clip.z( ) < -clip.w( ))
+        return false;
+
+      const Eigen::Vector3f ndc = clip.head< 3 >( ) / clip.w( );
+      ndcMinimum = ndcMinimum.cwiseMin( ndc );
+      ndcMaximum = ndcMaximum.cwiseMax( ndc );
+    }
+
+    // Boxes outside the view are culled as well
+    if ( ndcMaximum.x( ) < -1.0f || ndcMinimum.x( ) > 1.0f ||
+         ndcMaximum.y( ) < -1.0f || ndcMinimum.y( ) > 1.0f ||
+         ndcMinimum.z( ) > 1.0f )
+      return true;
+
+    const auto& base = _levels.front( );
+    auto toPixel = [ ]( float ndc , unsigned int size )
+    {
+      const float position =
+        ( std::min( 1.0f , std::max( -1.0f , ndc )) * 0.5f + 0.5f ) * size;
+      return std::min( size - 1 , static_cast< unsigned int >( position ));
+    };
+    unsigned int x0 = toPixel( ndcMinimum.x( ) , base.width );
+    unsigned int x1 = toPixel( ndcMaximum.x( ) , base.width );
+    unsigned int y0 = toPixel( ndcMinimum.y( ) , base.height );
+    unsigned int y1 = toPixel( ndcMaximum.y( ) , base.height );
+
+    // Coarsest level where the rectangle spans a few texels
+    const unsigned int size = std::max( x1 - x0 , y1 - y0 ) + 1;
+    size_t level = 0;
+    while ( level + 1 < _levels.size( ) && ( size >> level ) > TEST_TEXELS )
+      ++level;
+    x0 >>= level;
+    x1 >>= level;
+    y0 >>= level;
+    y1 >>= level;
+
+    const auto& pyramid = _levels[ level ];
+    const float depth = ndcMinimum.z( ) * 0.5f + 0.5f;
+    for ( unsigned int y = y0; y <= std::min( y1 , pyramid.height - 1 ); ++y )
+    {
+      const auto row = &pyramid.depth[ static_cast< size_t >( y ) * pyramid.width ];
+      for ( unsigned int x = x0; x <= std::min( x1 , pyramid.width - 1 ); ++x )
+        if ( row[ x ] >= depth )
+          return false;
+    }
+    return true;
+  }
+}
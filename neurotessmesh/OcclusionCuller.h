@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_OCCLUSIONCULLER_H_
+#define NEUROTESSMESH_OCCLUSIONCULLER_H_
+
+// Eigen
+#include <Eigen/Dense>
+
+// C++
+#include <vector>
+
+namespace neurotessmesh
+{
+  /** \class OcclusionCuller
+   * \brief Tests bounding boxes against a hierarchical depth buffer.
+   *
+   * The depth buffer of the occluders is turned into a pyramid where each
+   * texel keeps the farthest depth of the texels it covers. A box is
+   * occluded when its nearest depth is behind the farthest depth of the
+   * few pyramid texels covering its screen rectangle, which makes the test
+   * conservative and constant time.
+   *
+   */
+  class OcclusionCuller
+  {
+  public:
+    OcclusionCuller( );
+
+    /** \brief Returns the storage of the full resolution depth buffer,
+     * resized to the given size. Rows are stored from bottom to top, as
+     * read by glReadPixels.
+     * \param[in] width Buffer width.
+     * \param[in] height Buffer height.
+     *
+     */
+    std::vector< float >& depthBuffer( unsigned int width , unsigned int height );
+
+    /** \brief Builds the depth pyramid from the depth buffer.
+     * \param[in] viewProjection Projection matrix multiplied by the view
+     * matrix used to render the depth buffer.
+     *
+     */
+    void update( const Eigen::Matrix4f& viewProjection );
+
+    /** \brief Removes the depth pyramid, no box is occluded afterwards.
+     *
+     */
+    void clear( );
+
+    /** \brief Returns true if the depth pyramid was rendered with the given
+     * matrices.
+     * \param[in] viewProjection Projection matrix multiplied by the view
+     * matrix.
+     *
+     */
+    bool current( const Eigen::Matrix4f& viewProjection ) const;
+
+    /** \brief Returns true if the box is hidden behind the depth buffer or
+     * outside the view.
+     * \param[in] minimum Minimum corner of the box in world coordinates.
+     * \param[in] maximum Maximum corner of the box in world coordinates.
+     *
+     */
+    bool occluded( const Eigen::Vector3f& minimum ,
+                   const Eigen::Vector3f& maximum ) const;
+
+  private:
+    struct Level
+    {
+      unsigned int width;
+      unsigned int height;
+      std::vector< float > depth;
+    };
+
+    //! Texels per side of the screen rectangle tested at the chosen level
+    static constexpr unsigned int TEST_TEXELS = 4;
+
+    std::vector< Level > _levels;
+    //! Unaligned, the culler is a member of heap allocated classes
+    Eigen::Matrix< float , 4 , 4 , Eigen::DontAlign > _viewProjection;
+    bool _valid;
+  };
+}
+
+#endif /* NEUROTESSMESH_OCCLUSIONCULLER_H_ */
@@ -14,7 +14,9 @@
 #include "Scene.h"
 
 #include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
 #include <QMouseEvent>
+#include <QPainter>
 #include <QColorDialog>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -24,7 +26,13 @@
 #include <string>
 #include <iostream>
 #include <utility>
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <set>
 
 #include <nlrender/nlrender.h>
 
@@ -36,6 +44,24 @@ const QString FPSLABEL_STYLESHEET = "QLabel { background-color : #333;"
 
 const float FRAME_TIME = 1.f/60.f;
 
+// Full screen triangle upscaling the reduced resolution frames
+const char* const UPSCALE_VERTEX_SHADER = R"(#version 330 core
+out vec2 uv;
+void main( )
+{
+  uv = vec2(( gl_VertexID << 1 ) & 2 , gl_VertexID & 2 );
+  gl_Position = vec4( uv * 2.0 - 1.0 , 0.0 , 1.0 );
+})";
+
+const char* const UPSCALE_FRAGMENT_SHADER = R"(#version 330 core
+uniform sampler2D frame;
+in vec2 uv;
+out vec4 fragColor;
+void main( )
+{
+  fragColor = texture( frame , uv );
+})";
+
 OpenGLWidget::OpenGLWidget( QWidget* parent_ ,
                             Qt::WindowFlags windowsFlags_ )
   : QOpenGLWidget( parent_ , windowsFlags_ )
@@ -44,8 +70,20 @@ OpenGLWidget::OpenGLWidget( QWidget* parent_ ,
   , _mouseY( 0 )
   , _rotation( false )
   , _translation( false )
+  , _pressX( 0 )
+  , _pressY( 0 )
+  , _hoveredNeuron( -1 )
+  , _regionSelection( false )
+  , _lasso( false )
+  , _regionChanged( false )
   , _translationScale( 0.1f )
   , _rotationScale( 0.01f )
+  , _interactiveScale( 0.5f )
+  , _interactiveSamples( 4 )
+  , _viewport{ 0 , 0 , 0 , 0 }
+  , _frameCaching( true )
+  , _frameCached( false )
+  , _frameVersion( 0 )
   , _wireframe( false )
   , _idleUpdate( false )
   , _fpsLabel( this )
@@ -54,6 +92,7 @@ OpenGLWidget::OpenGLWidget( QWidget* parent_ ,
 #ifdef NEUROTESSMESH_USE_LEXIS
 , _subscriber( nullptr )
 , _subscriberThread( nullptr )
+, _publisher( nullptr )
 #endif
 {
   try
@@ -74,18 +113,32 @@ OpenGLWidget::OpenGLWidget( QWidget* parent_ ,
   // This is needed to get key events
   this->setFocusPolicy( Qt::WheelFocus );
 
+  // Move events without buttons pressed drive the hover highlighting
+  setMouseTracking( true );
+
   _lastSavedFileName = QDir::currentPath( );
 }
 
 OpenGLWidget::~OpenGLWidget( )
 {
+  makeCurrent( );
+  _reducedFramebuffer.reset( );
+  _resolvedFramebuffer.reset( );
+  _frameCache.reset( );
+  _upscaleVertexArray.destroy( );
+  doneCurrent( );
+
   delete _camera;
   delete _cameraTimer;
+#ifdef NEUROTESSMESH_USE_LEXIS
+  delete _publisher;
+#endif
 }
 
 void OpenGLWidget::setScene( std::shared_ptr< neurotessmesh::Scene > scene )
 {
   _scene = std::move( scene );
+  _frameCached = false;
   makeCurrent( );
 }
 
@@ -146,6 +199,9 @@ void OpenGLWidget::setZeqSession( const std::string&
                     focusedData, focusedSize ));});
 #endif
 
+      delete _publisher;
+      _publisher = new zeroeq::Publisher(session_);
+
       _subscriberThread = new std::thread([&]()
       {
         try
@@ -207,6 +263,7 @@ void OpenGLWidget::toggleWireframe()
 {
   makeCurrent();
   _wireframe = !_wireframe;
+  _frameCached = false;
 
   if (_wireframe)
   {
@@ -261,6 +318,146 @@ void OpenGLWidget::extractMesh(const std::string &path)
   glUseProgram(0);
 }
 
+QImage OpenGLWidget::renderImage( const QSize& size_ )
+{
+  if ( !_scene || size_.isEmpty( ))
+    return QImage( );
+
+  constexpr int MAX_TILE_SIZE = 4096;
+
+  makeCurrent( );
+
+  // Lazy or budgeted meshes are generated a few per update, offscreen
+  // images wait for all the visible ones instead of drawing placeholders.
+  do
+    _scene->update( );
+  while ( _scene->meshesPending( ));
+
+  GLint maxViewport[ 2 ];
+  glGetIntegerv( GL_MAX_VIEWPORT_DIMS , maxViewport );
+  const int tileSize = std::min( MAX_TILE_SIZE ,
+                                 std::min( maxViewport[ 0 ] , maxViewport[ 1 ]));
+  const int tileWidth = std::min( tileSize , size_.width( ));
+  const int tileHeight = std::min( tileSize , size_.height( ));
+
+  // Tiles are rendered with the widget multisampling and resolved to a
+  // single sample framebuffer to be read.
+  const int samples = std::max( 0 , this->format( ).samples( ));
+  QOpenGLFramebufferObjectFormat format;
+  format.setAttachment( QOpenGLFramebufferObject::Depth );
+  format.setSamples( samples );
+  QOpenGLFramebufferObject fbo( tileWidth , tileHeight , format );
+  if ( !fbo.isValid( ))
+    return QImage( );
+
+  std::unique_ptr< QOpenGLFramebufferObject > resolved;
+  if ( samples > 0 )
+  {
+    resolved.reset( new QOpenGLFramebufferObject( tileWidth , tileHeight ));
+    if ( !resolved->isValid( ))
+      return QImage( );
+  }
+
+  GLint viewport[ 4 ];
+  glGetIntegerv( GL_VIEWPORT , viewport );
+
+  // Keeps the tessellation density relative to the output pixels.
+  const float lod = _scene->levelOfDetail( );
+  const float magnification = static_cast< float >( size_.width( )) /
+                              std::max( 1 , viewport[ 2 ]);
+  _scene->levelOfDetail( lod * std::max( 1.0f , magnification ));
+
+  // The occlusion culling tests against the depth of a previous frame, it
+  // would cull the neurons entering each tile.
+  const bool occlusionCulling = _scene->occlusionCulling( );
+  if ( occlusionCulling )
+    _scene->occlusionCulling( false );
+
+  QImage image( size_ , QImage::Format_RGBA8888 );
+  uchar* bits = image.bits( );
+  const int bytesPerLine = image.bytesPerLine( );
+
+  const Eigen::Matrix4f projection(
+    _camera->camera( )->projectionMatrix( ));
+  const float width = static_cast< float >( size_.width( ));
+  const float height = static_cast< float >( size_.height( ));
+
+  fbo.bind( );
+  std::vector< std::future< void >> stitches;
+  for ( int y0 = 0; y0 < size_.height( ); y0 += tileHeight )
+  {
+    for ( int x0 = 0; x0 < size_.width( ); x0 += tileWidth )
+    {
+      const int w = std::min( tileWidth , size_.width( ) - x0 );
+      const int h = std::min( tileHeight , size_.height( ) - y0 );
+
+      // Maps the tile region of the normalized device coordinates to [-1,1].
+      // Image rows grow downwards while the NDC y axis grows upwards.
+      const float scaleX = width / w;
+      const float scaleY = height / h;
+      const float centerX = ( 2.0f * x0 + w ) / width - 1.0f;
+      const float centerY = 1.0f - ( 2.0f * y0 + h ) / height;
+      Eigen::Matrix4f tile = Eigen::Matrix4f::Identity( );
+      tile( 0 , 0 ) = scaleX;
+      tile( 0 , 3 ) = -centerX * scaleX;
+      tile( 1 , 1 ) = scaleY;
+      tile( 1 , 3 ) = -centerY * scaleY;
+
+      glViewport( 0 , 0 , w , h );
+      glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+      _scene->render( tile * projection );
+      glUseProgram( 0 );
+
+      if ( resolved )
+      {
+        const QRect rect( 0 , 0 , w , h );
+        QOpenGLFramebufferObject::blitFramebuffer(
+          resolved.get( ) , rect , &fbo , rect , GL_COLOR_BUFFER_BIT );
+        resolved->bind( );
+      }
+
+      auto pixels = std::make_shared< std::vector< uchar >>(
+        static_cast< size_t >( w ) * h * 4 );
+      glPixelStorei( GL_PACK_ALIGNMENT , 1 );
+      glReadPixels( 0 , 0 , w , h , GL_RGBA , GL_UNSIGNED_BYTE , pixels->data( ));
+      fbo.bind( );
+
+      // Flips and copies the tile while the next one is being rendered.
+      stitches.push_back( std::async( std::launch::async ,
+        [ bits , bytesPerLine , pixels , x0 , y0 , w , h ]( )
+        {
+          for ( int row = 0; row < h; ++row )
+            std::memcpy( bits + ( y0 + h - 1 - row ) * bytesPerLine + x0 * 4 ,
+                         pixels->data( ) + static_cast< size_t >( row ) * w * 4 ,
+                         static_cast< size_t >( w ) * 4 );
+        }));
+    }
+  }
+  fbo.release( );
+
+  glBindFramebuffer( GL_FRAMEBUFFER , defaultFramebufferObject( ));
+  glViewport( viewport[ 0 ] , viewport[ 1 ] , viewport[ 2 ] , viewport[ 3 ]);
+  _scene->levelOfDetail( lod );
+  if ( occlusionCulling )
+    _scene->occlusionCulling( true );
+
+  for ( auto& stitch: stitches )
+    stitch.wait( );
+
+  return image;
+}
+
+void OpenGLWidget::interactiveQuality( float scale_ , int samples_ )
+{
+  _interactiveScale = std::max( 0.1f , std::min( 1.0f , scale_ ));
+  _interactiveSamples = std::max( 0 , samples_ );
+
+  makeCurrent( );
+  _reducedFramebuffer.reset( );
+  _resolvedFramebuffer.reset( );
+  update( );
+}
+
 void OpenGLWidget::extractEditNeuronMesh()
 {
   if ( _scene->isEditNeuronMeshExtraction( ))
@@ -397,15 +594,66 @@ void OpenGLWidget::initializeGL( )
 
 void OpenGLWidget::paintGL( )
 {
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
   if (_scene != nullptr)
-  {
     _scene->update();
-    _scene->render();
+
+  // The camera timer keeps repainting, so the first frame after the view
+  // settles is already rendered at full quality.
+  const bool reduced = _scene && _interactiveScale < 1.0f &&
+                       _isInteracting() && _beginReducedFrame();
+
+  if (reduced || !_restoreFrame())
+  {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    if (reduced)
+    {
+      // Keeps the tessellation density relative to the rendered pixels
+      const float lod = _scene->levelOfDetail();
+      _scene->levelOfDetail(lod * _interactiveScale);
+      _scene->render();
+      _scene->levelOfDetail(lod);
+    }
+    else if (_scene != nullptr)
+      _scene->render();
+
+    glUseProgram(0);
+
+    if (reduced)
+    {
+      _endReducedFrame();
+      _frameCached = false;
+    }
+    // The next frame differs while the occlusion culling settles
+    else if (_scene && _scene->occlusionPending())
+      _frameCached = false;
+    else
+      _storeFrame();
   }
 
-  glUseProgram(0);
+  if (_regionSelection && _region.size() > 1)
+  {
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(palette().highlight().color(), 1, Qt::DashLine));
+    painter.setBrush(QColor(255, 255, 255, 32));
+    if (_lasso)
+      painter.drawPolygon(_region);
+    else
+      painter.drawRect(QRect(_region.first(), _region.last()).normalized());
+
+    // The scene selection only changes on release, the frame is reused
+    constexpr qreal HIT_RADIUS = 3.0;
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(palette().highlight());
+    for (const auto &hit: _regionHits)
+      painter.drawEllipse(hit, HIT_RADIUS, HIT_RADIUS);
+    painter.end();
+
+    // QPainter changes the GL state the scene relies on
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+  }
   glFlush();
 
 #define FRAMES_PAINTED_TO_MEASURE_FPS 10
@@ -446,6 +694,11 @@ void OpenGLWidget::paintGL( )
   else
   {
     _fpsLabel.setVisible(false);
+
+    // Meshes are generated a few per frame and the occlusion culling
+    // depth is read a frame later
+    if (_scene && (_scene->meshesPending() || _scene->occlusionPending()))
+      update();
   }
 }
 
@@ -457,11 +710,31 @@ void OpenGLWidget::resizeGL( int width_ , int height_ )
 
 void OpenGLWidget::mousePressEvent( QMouseEvent* event_ )
 {
+  const auto modifiers = event_->modifiers();
+  if (event_->button() == Qt::LeftButton &&
+      (modifiers.testFlag(Qt::ShiftModifier) || modifiers.testFlag(Qt::AltModifier)))
+  {
+    // Shift drags a rubber band and alt a lasso, control adds to the selection
+    _regionSelection = true;
+    _lasso = !modifiers.testFlag(Qt::ShiftModifier);
+    _region = QPolygon() << event_->pos() << event_->pos();
+    _regionSelected.clear();
+    _regionHits.clear();
+    _regionChanged = false;
+    _regionBase.clear();
+    if (_scene && modifiers.testFlag(Qt::ControlModifier))
+    {
+      const auto &selection = _scene->selectedIndices();
+      _regionBase.assign(selection.begin(), selection.end());
+    }
+    return;
+  }
+
   if (event_->button() == Qt::LeftButton)
   {
     _rotation = true;
-    _mouseX = event_->x();
-    _mouseY = event_->y();
+    _mouseX = _pressX = event_->x();
+    _mouseY = _pressY = event_->y();
   }
 
   if (event_->button() == Qt::MidButton)
@@ -474,9 +747,26 @@ void OpenGLWidget::mousePressEvent( QMouseEvent* event_ )
 
 void OpenGLWidget::mouseReleaseEvent( QMouseEvent* event_ )
 {
+  // Less than this displacement in pixels is a click, not a rotation
+  constexpr int CLICK_THRESHOLD = 3;
+
+  if (event_->button() == Qt::LeftButton && _regionSelection)
+  {
+    _regionSelection = false;
+    _region.clear();
+    _regionHits.clear();
+    if (_scene && _regionChanged)
+      _commitRegion();
+    update();
+    return;
+  }
+
   if (event_->button() == Qt::LeftButton)
   {
     _rotation = false;
+
+    if (std::abs(event_->x() - _pressX) + std::abs(event_->y() - _pressY) <= CLICK_THRESHOLD)
+      _pickNeuron(event_->x(), event_->y(), event_->modifiers().testFlag(Qt::ControlModifier));
   }
 
   if (event_->button() == Qt::MidButton)
@@ -499,6 +789,24 @@ void OpenGLWidget::mouseMoveEvent( QMouseEvent* event_ )
     _mouseY = e->y( );
   };
 
+  if (_regionSelection)
+  {
+    // Lasso vertices closer than this in pixels are skipped
+    constexpr int LASSO_SPACING = 2;
+
+    if (!_lasso)
+      _region.last() = event_->pos();
+    else if ((event_->pos() - _region.last()).manhattanLength() >= LASSO_SPACING)
+      _region << event_->pos();
+
+    _selectRegion();
+    update();
+    return;
+  }
+
+  if (_rotation || _translation)
+    _lastInteraction = std::chrono::steady_clock::now();
+
   if (_rotation)
   {
     _camera->rotate(Eigen::Vector3f(diffX * ROTATION_FACTOR, diffY * ROTATION_FACTOR, 0.0f));
@@ -515,12 +823,19 @@ void OpenGLWidget::mouseMoveEvent( QMouseEvent* event_ )
     updateLastEventCoords(event_);
   }
 
+  if (!_rotation && !_translation)
+  {
+    _hoverNeuron(event_->x(), event_->y());
+    return;
+  }
+
   update();
 }
 
 void OpenGLWidget::wheelEvent( QWheelEvent* event_ )
 {
   int delta = event_->angleDelta().y();
+  _lastInteraction = std::chrono::steady_clock::now();
 
   if (delta > 0)
     _camera->radius(_camera->radius() / 1.1f);
@@ -545,10 +860,259 @@ void OpenGLWidget::keyPressEvent( QKeyEvent* event_ )
   }
 }
 
+void OpenGLWidget::_pickNeuron( int x_ , int y_ , bool toggle_ )
+{
+  unsigned int id;
+  if ( !_scene || !_scene->pickNeuron( x_ , y_ , width( ) , height( ) , id ))
+    return;
+
+  const auto& selection = _scene->selectedIndices( );
+  std::set< unsigned int > selected;
+  if ( toggle_ )
+    selected = selection;
+  if ( !toggle_ || !selected.erase( id ))
+    selected.insert( id );
+
+  const std::vector< unsigned int > ids( selected.begin( ) , selected.end( ));
+  makeCurrent( );
+  _scene->changeSelectedIndices( ids );
+  update( );
+
+  _publishSelection( ids );
+}
+
+void OpenGLWidget::_selectRegion( )
+{
+  if ( !_scene || ( _lasso && _region.size( ) < 3 ))
+    return;
+
+  std::vector< Eigen::Vector2f > region;
+  region.reserve( static_cast< size_t >( _region.size( )));
+  for ( const auto& point: _region )
+    region.emplace_back( point.x( ) , point.y( ));
+
+  const auto ids = _scene->neuronsInRegion( region , width( ) , height( ));
+  if ( _regionChanged && ids == _regionSelected )
+    return;
+  _regionChanged = true;
+  _regionSelected = ids;
+
+  _regionHits.clear( );
+  for ( const auto& position: _scene->somaPositions( ids , width( ) , height( )))
+    _regionHits << QPointF( position.x( ) , position.y( ));
+}
+
+void OpenGLWidget::_commitRegion( )
+{
+  auto ids = _regionSelected;
+  if ( !_regionBase.empty( ))
+  {
+    std::vector< unsigned int > merged;
+    std::set_union( _regionBase.begin( ) , _regionBase.end( ) ,
+                    ids.begin( ) , ids.end( ) , std::back_inserter( merged ));
+    ids.swap( merged );
+  }
+
+  makeCurrent( );
+  _scene->changeSelectedIndices( ids );
+  _publishSelection( ids );
+}
+
+void OpenGLWidget::_publishSelection( const std::vector< unsigned int >& ids_ )
+{
+#ifdef NEUROTESSMESH_USE_LEXIS
+  if ( _publisher )
+    _publisher->publish( lexis::data::SelectedIDs( ids_ ));
+#else
+  ( void ) ids_;
+#endif
+
+  emit neuronsPicked( );
+}
+
+void OpenGLWidget::_hoverNeuron( int x_ , int y_ )
+{
+  if ( !_scene )
+    return;
+
+  unsigned int id;
+  const long hovered = _scene->pickNeuron( x_ , y_ , width( ) , height( ) , id ) ?
+    static_cast< long >( id ) : -1;
+
+  if ( hovered != _hoveredNeuron )
+  {
+    _hoveredNeuron = hovered;
+    emit neuronHovered( static_cast< int >( hovered ));
+  }
+}
+
+bool OpenGLWidget::_isInteracting( ) const
+{
+  // Camera input closer than this keeps the reduced quality between events
+  constexpr std::chrono::milliseconds SETTLE_TIME( 150 );
+
+  return _camera->isAniming( ) ||
+         std::chrono::steady_clock::now( ) - _lastInteraction < SETTLE_TIME;
+}
+
+bool OpenGLWidget::_beginReducedFrame( )
+{
+  if ( !_upscaleProgram.isLinked( ))
+  {
+    if ( !_upscaleProgram.addShaderFromSourceCode( QOpenGLShader::Vertex ,
+                                                   UPSCALE_VERTEX_SHADER ) ||
+         !_upscaleProgram.addShaderFromSourceCode( QOpenGLShader::Fragment ,
+                                                   UPSCALE_FRAGMENT_SHADER ) ||
+         !_upscaleProgram.link( ))
+    {
+      std::cerr << "Interactive frames upscaling not available" << std::endl;
+      _interactiveScale = 1.0f;
+      return false;
+    }
+    _upscaleProgram.bind( );
+    _upscaleProgram.setUniformValue( "frame" , 0 );
+    _upscaleProgram.release( );
+
+    // Core profiles need a vertex array even without attributes
+    _upscaleVertexArray.create( );
+  }
+
+  glGetIntegerv( GL_VIEWPORT , _viewport );
+  const QSize size(
+    std::max( 1 , static_cast< int >( _viewport[ 2 ] * _interactiveScale )) ,
+    std::max( 1 , static_cast< int >( _viewport[ 3 ] * _interactiveScale )));
+
+  if ( !_reducedFramebuffer || _reducedFramebuffer->size( ) != size )
+  {
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment( QOpenGLFramebufferObject::Depth );
+    format.setSamples( _interactiveSamples );
+    _reducedFramebuffer.reset( new QOpenGLFramebufferObject( size , format ));
+
+    // Multisampled framebuffers are resolved before being sampled
+    _resolvedFramebuffer.reset( _interactiveSamples > 0 ?
+                                new QOpenGLFramebufferObject( size ) : nullptr );
+
+    const auto& sampled = _resolvedFramebuffer ? _resolvedFramebuffer
+                                               : _reducedFramebuffer;
+    if ( !_reducedFramebuffer->isValid( ) || !sampled->isValid( ))
+    {
+      std::cerr << "Interactive frames framebuffer not available" << std::endl;
+      _reducedFramebuffer.reset( );
+      _resolvedFramebuffer.reset( );
+      _interactiveScale = 1.0f;
+      return false;
+    }
+
+    glBindTexture( GL_TEXTURE_2D , sampled->texture( ));
+    glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_MIN_FILTER , GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_MAG_FILTER , GL_LINEAR );
+    glBindTexture( GL_TEXTURE_2D , 0 );
+  }
+
+  _reducedFramebuffer->bind( );
+  glViewport( 0 , 0 , size.width( ) , size.height( ));
+  return true;
+}
+
+void OpenGLWidget::_endReducedFrame( )
+{
+  if ( _resolvedFramebuffer )
+    QOpenGLFramebufferObject::blitFramebuffer( _resolvedFramebuffer.get( ) ,
+                                               _reducedFramebuffer.get( ));
+
+  const auto& sampled = _resolvedFramebuffer ? _resolvedFramebuffer
+                                             : _reducedFramebuffer;
+
+  glBindFramebuffer( GL_FRAMEBUFFER , defaultFramebufferObject( ));
+  glViewport( _viewport[ 0 ] , _viewport[ 1 ] , _viewport[ 2 ] , _viewport[ 3 ]);
+
+  glDisable( GL_DEPTH_TEST );
+  _upscaleProgram.bind( );
+  _upscaleVertexArray.bind( );
+  glActiveTexture( GL_TEXTURE0 );
+  glBindTexture( GL_TEXTURE_2D , sampled->texture( ));
+  glDrawArrays( GL_TRIANGLES , 0 , 3 );
+  glBindTexture( GL_TEXTURE_2D , 0 );
+  _upscaleVertexArray.release( );
+  _upscaleProgram.release( );
+  glEnable( GL_DEPTH_TEST );
+}
+
+bool OpenGLWidget::_restoreFrame( )
+{
+  // Continuous updates are kept to measure the rendering frame rate
+  if ( !_frameCached || !_scene || _idleUpdate )
+    return false;
+
+  GLint viewport[ 4 ];
+  glGetIntegerv( GL_VIEWPORT , viewport );
+  const auto camera = _camera->camera( );
+  if ( _scene->version( ) != _frameVersion ||
+       _frameCache->size( ) != QSize( viewport[ 2 ] , viewport[ 3 ]) ||
+       Eigen::Matrix4f( camera->viewMatrix( )) != _frameView ||
+       Eigen::Matrix4f( camera->projectionMatrix( )) != _frameProjection )
+    return false;
+
+  const QRect rect( QPoint( 0 , 0 ) , _frameCache->size( ));
+  QOpenGLFramebufferObject::blitFramebuffer(
+    nullptr , rect , _frameCache.get( ) , rect ,
+    GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+  glBindFramebuffer( GL_FRAMEBUFFER , defaultFramebufferObject( ));
+  return true;
+}
+
+void OpenGLWidget::_storeFrame( )
+{
+  _frameCached = false;
+  if ( !_scene || !_frameCaching )
+    return;
+
+  GLint viewport[ 4 ];
+  glGetIntegerv( GL_VIEWPORT , viewport );
+  const QSize size( viewport[ 2 ] , viewport[ 3 ]);
+  if ( size.isEmpty( ))
+    return;
+
+  // Multisampled framebuffers can only be copied to framebuffers with the
+  // same samples and formats, as the widget one.
+  if ( !_frameCache || _frameCache->size( ) != size )
+  {
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment( QOpenGLFramebufferObject::CombinedDepthStencil );
+    format.setSamples( std::max( 0 , this->format( ).samples( )));
+    _frameCache.reset( new QOpenGLFramebufferObject( size , format ));
+  }
+
+  while ( glGetError( ) != GL_NO_ERROR );
+
+  const QRect rect( QPoint( 0 , 0 ) , size );
+  if ( _frameCache->isValid( ))
+    QOpenGLFramebufferObject::blitFramebuffer(
+      _frameCache.get( ) , rect , nullptr , rect ,
+      GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+  glBindFramebuffer( GL_FRAMEBUFFER , defaultFramebufferObject( ));
+
+  if ( !_frameCache->isValid( ) || glGetError( ) != GL_NO_ERROR )
+  {
+    std::cerr << "Frame caching not available" << std::endl;
+    _frameCache.reset( );
+    _frameCaching = false;
+    return;
+  }
+
+  const auto camera = _camera->camera( );
+  _frameVersion = _scene->version( );
+  _frameView = Eigen::Matrix4f( camera->viewMatrix( ));
+  _frameProjection = Eigen::Matrix4f( camera->projectionMatrix( ));
+  _frameCached = true;
+}
+
 void OpenGLWidget::changeClearColor( QColor qColor )
 {
   makeCurrent( );
   glClearColor( qColor.redF( ) , qColor.greenF( ) , qColor.blueF( ) , 1.0f );
+  _frameCached = false;
   update( );
 }
 
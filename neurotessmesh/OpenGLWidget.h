@@ -13,9 +13,13 @@
 
 #include <QOpenGLFunctions>
 #include <QOpenGLWidget>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
 #include <QLabel>
 #include <QTimer>
 #include <QColor>
+#include <QPolygon>
+#include <QPointF>
 
 #include <Eigen/Eigen>
 
@@ -37,6 +41,8 @@ namespace neurotessmesh
   class Scene;
 }
 
+class QOpenGLFramebufferObject;
+
 namespace reto
 {
   class OrbitalCameraController;
@@ -172,6 +178,39 @@ public:
   */
   void extractMesh(const std::string &path);
 
+  /** \brief Renders the scene offscreen at the given size, splitting it in
+   * tiles when it's bigger than the maximum framebuffer size. The visible
+   * meshes still pending are generated first.
+   * \param[in] size_ Image size in pixels.
+   * \returns Rendered image or a null image if there's no scene.
+   *
+   */
+  QImage renderImage( const QSize& size_ );
+
+  /** \brief Sets the quality of the frames rendered while the camera is
+   * moving. They are rendered offscreen at a fraction of the viewport size
+   * and upscaled, the next frame after the view settles is rendered at full
+   * quality.
+   * \param[in] scale_ Resolution scale, 1 to always render at full quality.
+   * \param[in] samples_ Multisampling samples, 0 to disable it.
+   *
+   */
+  void interactiveQuality( float scale_ , int samples_ );
+
+signals:
+
+  /** \brief Emitted when the selection changes by picking neurons in the
+   * viewport.
+   *
+   */
+  void neuronsPicked( );
+
+  /** \brief Emitted when the neuron under the cursor changes.
+   * \param[in] id Id of the neuron or -1 if there's none.
+   *
+   */
+  void neuronHovered( int id );
+
 public slots:
 
   void toggleUpdateOnIdle();
@@ -227,14 +266,101 @@ protected:
 
   void keyPressEvent( QKeyEvent* event_ ) override;
 
+  /** \brief Selects the neuron at the given position. With the control key
+   * the neuron is toggled instead of replacing the selection.
+   *
+   */
+  void _pickNeuron( int x_ , int y_ , bool toggle_ );
+
+  /** \brief Finds the neurons inside the current region, only marked
+   * while dragging.
+   *
+   */
+  void _selectRegion( );
+
+  /** \brief Selects the neurons found inside the region.
+   *
+   */
+  void _commitRegion( );
+
+  /** \brief Sends the picked selection to the other applications and the
+   * main window.
+   * \param[in] ids_ Selected neuron ids.
+   *
+   */
+  void _publishSelection( const std::vector< unsigned int >& ids_ );
+
+  /** \brief Updates the neuron under the cursor.
+   *
+   */
+  void _hoverNeuron( int x_ , int y_ );
+
+  /** \brief Returns true while the camera is being moved or animated.
+   *
+   */
+  bool _isInteracting( ) const;
+
+  /** \brief Redirects the rendering to the reduced resolution framebuffer.
+   * \returns false if it can't be used, rendering at full quality.
+   *
+   */
+  bool _beginReducedFrame( );
+
+  /** \brief Upscales the reduced resolution frame to the widget.
+   *
+   */
+  void _endReducedFrame( );
+
+  /** \brief Copies the last frame to the widget if the scene, camera and
+   * viewport haven't changed since it was rendered.
+   * \returns false if the scene has to be rendered.
+   *
+   */
+  bool _restoreFrame( );
+
+  /** \brief Keeps a copy of the frame just rendered.
+   *
+   */
+  void _storeFrame( );
+
   std::shared_ptr< neurotessmesh::Scene > _scene;
   reto::OrbitalCameraController* _camera;
 
   int _mouseX , _mouseY;
   bool _rotation , _translation;
+  int _pressX , _pressY;
+  long _hoveredNeuron;
+
+  //! Rubber band corners or lasso vertices while dragging
+  QPolygon _region;
+  bool _regionSelection , _lasso , _regionChanged;
+  //! Selection the region is added to, empty to replace it
+  std::vector< unsigned int > _regionBase;
+  std::vector< unsigned int > _regionSelected;
+  //! Soma positions of the neurons inside the region, drawn over the frame
+  QVector< QPointF > _regionHits;
   float _translationScale;
   float _rotationScale;
 
+  //! Interactive frames quality and the time of the last camera input
+  float _interactiveScale;
+  int _interactiveSamples;
+  std::chrono::steady_clock::time_point _lastInteraction;
+
+  //! Reduced resolution frame, resolved to a texture when multisampled
+  std::unique_ptr< QOpenGLFramebufferObject > _reducedFramebuffer;
+  std::unique_ptr< QOpenGLFramebufferObject > _resolvedFramebuffer;
+  QOpenGLShaderProgram _upscaleProgram;
+  QOpenGLVertexArrayObject _upscaleVertexArray;
+  int _viewport[ 4 ];
+
+  //! Last full quality frame and what it was rendered from
+  std::unique_ptr< QOpenGLFramebufferObject > _frameCache;
+  bool _frameCaching , _frameCached;
+  unsigned long _frameVersion;
+  Eigen::Matrix< float , 4 , 4 , Eigen::DontAlign > _frameView;
+  Eigen::Matrix< float , 4 , 4 , Eigen::DontAlign > _frameProjection;
+
   bool _wireframe;
   bool _idleUpdate;
 
@@ -251,6 +377,8 @@ protected:
   zeroeq::Subscriber* _subscriber;
 
   std::thread* _subscriberThread;
+
+  zeroeq::Publisher* _publisher;
 #endif
 
 };
@@ -26,7 +26,111 @@
 #include <utility>
 #include <nlgenerator/nlgenerator.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+
 constexpr float CAMERA_ANIMATION_DURATION = 1.5f;
+constexpr unsigned int LAZY_MESHES_PER_FRAME = 8;
+constexpr size_t EDIT_MESH_CACHE_SIZE = 4;
+constexpr float EDIT_MESH_ALPHA_TOLERANCE = 1e-4f;
+
+namespace
+{
+  /** \brief Returns the normalized frustum planes of the given matrix.
+   * \param[in] viewProjection Projection matrix multiplied by view matrix.
+   *
+   */
+  std::array< Eigen::Vector4f , 6 >
+  frustumPlanes( const Eigen::Matrix4f& viewProjection )
+  {
+    const Eigen::Vector4f row0 = viewProjection.row( 0 ).transpose( );
+    const Eigen::Vector4f row1 = viewProjection.row( 1 ).transpose( );
+    const Eigen::Vector4f row2 = viewProjection.row( 2 ).transpose( );
+    const Eigen::Vector4f row3 = viewProjection.row( 3 ).transpose( );
+
+    std::array< Eigen::Vector4f , 6 > planes = {{
+      row3 + row0 , row3 - row0 , row3 + row1 ,
+      row3 - row1 , row3 + row2 , row3 - row2 }};
+
+    for ( auto& plane: planes )
+      plane /= plane.head< 3 >( ).norm( );
+
+    return planes;
+  }
+
+  /** \brief Returns true if the box is at least partially in the frustum.
+   * \param[in] planes Normalized frustum planes.
+   * \param[in] minimum Box minimum corner.
+   * \param[in] maximum Box maximum corner.
+   *
+   */
+  bool boxInFrustum( const std::array< Eigen::Vector4f , 6 >& planes ,
+                     const Eigen::Vector3f& minimum ,
+                     const Eigen::Vector3f& maximum )
+  {
+    for ( const auto& plane: planes )
+    {
+      // Corner furthest along the plane normal
+      const Eigen::Vector3f corner(
+        plane.x( ) >= 0.0f ? maximum.x( ) : minimum.x( ) ,
+        plane.y( ) >= 0.0f ? maximum.y( ) : minimum.y( ) ,
+        plane.z( ) >= 0.0f ? maximum.z( ) : minimum.z( ));
+      if ( plane.head< 3 >( ).dot( corner ) + plane.w( ) < 0.0f )
+        return false;
+    }
+    return true;
+  }
+
+  /** \brief Gathers the render tuple and colors of the given entries.
+   * \param[in] neurons Render tuple.
+   * \param[in] colors Colors of the render tuple entries.
+   * \param[in] entries Entries to gather.
+   * \param[out] result Render tuple of the entries.
+   * \param[out] resultColors Colors of the entries.
+   *
+   */
+  void gatherNeurons( const neurotessmesh::Scene::NeuronMeshes& neurons ,
+                      const std::vector< Eigen::Vector3f >& colors ,
+                      const std::vector< size_t >& entries ,
+                      neurotessmesh::Scene::NeuronMeshes& result ,
+                      std::vector< Eigen::Vector3f >& resultColors )
+  {
+    auto& meshes = std::get< 0 >( result );
+    auto& models = std::get< 1 >( result );
+    meshes.clear( );
+    models.clear( );
+    resultColors.clear( );
+    meshes.reserve( entries.size( ));
+    models.reserve( entries.size( ));
+    resultColors.reserve( entries.size( ));
+
+    for ( const auto entry: entries )
+    {
+      meshes.push_back( std::get< 0 >( neurons )[ entry ]);
+      models.push_back( std::get< 1 >( neurons )[ entry ]);
+      if ( entry < colors.size( ))
+        resultColors.push_back( colors[ entry ]);
+    }
+  }
+
+  /** \brief Returns the estimated GPU size of the mesh buffers. Must be
+   * called before releasing the mesh CPU data.
+   * \param[in] mesh Neuron mesh.
+   * \param[in] numAttribs Number of float3 vertex attributes uploaded.
+   *
+   */
+  size_t meshGPUBytes( const nlgeometry::MeshPtr mesh , const size_t numAttribs )
+  {
+    const size_t vertexBytes = numAttribs * 3 * sizeof( float );
+    const size_t numIndices = mesh->triangles( ).size( ) * 3 +
+                              mesh->quads( ).size( ) * 4;
+
+    return mesh->vertices( ).size( ) * vertexBytes +
+           numIndices * sizeof( unsigned int );
+  }
+}
 
 namespace neurotessmesh
 {
@@ -35,7 +139,10 @@ namespace neurotessmesh
 #ifdef NEUROTESSMESH_USE_SIMIL
                 , simil::SpikesPlayer* player
 #endif
-                )
+                , bool simplifiedMorphologies
+                , bool lazyMeshes
+                , size_t meshMemoryLimit
+                , MeshResidencyManager::EvictionPolicy meshEvictionPolicy )
     : _mode( VISUALIZATION )
     , _colorMode(SELECTION)
     , _camera( camera )
@@ -45,12 +152,25 @@ namespace neurotessmesh
 #ifdef NEUROTESSMESH_USE_SIMIL
     , _simulationPlayer( player )
 #endif
+    , _simplifiedMorphologies( simplifiedMorphologies )
+    , _lazyMeshes( lazyMeshes )
+    , _meshesPending( false )
+    , _placeholderMorphology( nullptr )
+    , _placeholderMesh( nullptr )
+    , _clippingDirty( true )
+    , _occlusionCulling( false )
+    , _occlusionPending( false )
+    , _renderPassesDirty( true )
+    , _unselectedAlpha( 1.0f )
+    , _version( 0 )
     , _paintUnselectedSoma( true )
     , _paintUnselectedNeurites( true )
     , _paintSelectedSoma( true )
     , _paintSelectedNeurites( true )
     , _editNeuron( nullptr )
     , _editMesh( nullptr )
+    , _editParameters{ 1.0f , {} , nullptr , 0 }
+    , _editParametersValid( false )
     , _boundingBox( Eigen::Vector3f::Zero( ) , Eigen::Vector3f::Zero( ))
     , _activationTimestamps( )
     , _gradient( {{ 0.0f , Eigen::Vector3f{ 1.0f , 0.0f , 0.0f }} ,
@@ -63,7 +183,11 @@ namespace neurotessmesh
     _attribsFormat[ 2 ] = nlgeometry::TAttribType::TANGENT;
 
     initColors();
+    _residency.budget( meshMemoryLimit );
+    _residency.policy( meshEvictionPolicy );
     generateMeshes( );
+    _neuronBounds.build( _dataSet->neurons( ));
+    _neuronPicker.build( _dataSet->neurons( ) , _neuronBounds );
     _boundingBox = computeBoundingBox( );
 
     const auto fov = _camera->camera()->fieldOfView();
@@ -72,11 +196,12 @@ namespace neurotessmesh
     _camera->position( _boundingBox.center( ));
     _camera->radius(radius);
     conformRenderTuples( );
-    rebuildNeuronsColors();
   }
 
   Scene::~Scene( )
   {
+    _unselectedLayer.release( );
+    _depthReadback.release( );
     delete _renderer;
     if ( _dataSet )
     {
@@ -88,6 +213,7 @@ namespace neurotessmesh
   void Scene::mode( const Scene::TSceneMode mode_ )
   {
     _mode = mode_;
+    ++_version;
   }
 
   Scene::TSceneMode Scene::mode( ) const
@@ -97,6 +223,9 @@ namespace neurotessmesh
 
   void Scene::update( )
   {
+    if (( _lazyMeshes || _residency.budget( ) > 0 ) && updateResidentMeshes( ))
+      conformRenderTuples( );
+
 #ifdef NEUROTESSMESH_USE_SIMIL
     static float timeStamp = -1;
 
@@ -107,6 +236,7 @@ namespace neurotessmesh
       if(currentTime - timeStamp > std::numeric_limits<float>::epsilon())
       {
         timeStamp = currentTime;
+        ++_version;
 
         auto spikes = _simulationPlayer->spikesNow( );
 
@@ -124,37 +254,41 @@ namespace neurotessmesh
 #endif
   }
 
+  unsigned long Scene::version( ) const
+  {
+    return _version;
+  }
+
   void Scene::render()
   {
-    Eigen::Matrix4f projection( _camera->camera( )->projectionMatrix( ));
-    _renderer->projectionMatrix( ) = projection;
+    render( Eigen::Matrix4f( _camera->camera( )->projectionMatrix( )));
+  }
+
+  void Scene::render( const Eigen::Matrix4f& projection_ )
+  {
+    _renderer->projectionMatrix( ) = projection_;
     Eigen::Matrix4f view( _camera->camera( )->viewMatrix( ));
     _renderer->viewMatrix( ) = view;
 
+    if ( !_clippingPlanes.empty( ) && _clippingDirty )
+      updateClipping( );
+
+    if ( _renderPassesDirty )
+    {
+      _renderPassesDirty = false;
+      const bool clipping = !_clippingPlanes.empty( );
+      buildRenderPasses( clipping ? &_clippedUnselectedEntries : nullptr ,
+                         clipping ? &_clippedSelectedEntries : nullptr ,
+                         _renderPasses );
+    }
+
     switch ( _mode )
     {
       case VISUALIZATION:
-#ifdef NEUROTESSMESH_USE_SIMIL
-      {
-        const float timeStamp = _simulationPlayer ? _simulationPlayer->currentTime() : 0.f;
-          _renderer->render( std::get< 0 >( _unselectedNeurons ) ,
-                             std::get< 1 >( _unselectedNeurons ) ,
-                             _unselectedColors, _simulationPlayer ?
-                             calculateUnselectedColors(timeStamp):_unselectedColors , true ,
-                             _paintUnselectedSoma ,
-                             _paintUnselectedNeurites );
-      }
-#else
-      _renderer->render( std::get< 0 >( _unselectedNeurons ) ,
-                         std::get< 1 >( _unselectedNeurons ) ,
-                         _unselectedColors, _unselectedColors, true , _paintSelectedSoma ,
-                         _paintSelectedNeurites );
-#endif
-
-        _renderer->render( std::get< 0 >( _selectedNeurons ) ,
-                           std::get< 1 >( _selectedNeurons ) ,
-                           _selectedColors, _selectedColors, true , _paintSelectedSoma ,
-                           _paintSelectedNeurites );
+        if ( _occlusionCulling )
+          renderOccluded( projection_ * view );
+        else
+          renderNeurons( nullptr , nullptr );
         break;
       case EDITION:
         if ( isEditNeuronMeshExtraction( ) && _editMesh)
@@ -177,16 +311,30 @@ namespace neurotessmesh
 
   void Scene::close( )
   {
+    clearEditMeshCache( );
     _editNeuron = nullptr;
     _editMesh = nullptr;
     for ( auto neuronMesh: _neuronMeshes )
       delete neuronMesh.second;
     _neuronMeshes.clear( );
+    _preparedMorphologies.clear( );
+    _residency.clear( );
+    _pendingMeshes.clear( );
+    _meshesPending = false;
+    _neuronBounds.clear( );
+    _neuronPicker.clear( );
+
+    delete _placeholderMesh;
+    _placeholderMesh = nullptr;
+    delete _placeholderMorphology;
+    _placeholderMorphology = nullptr;
 
     std::get< 0 >( _unselectedNeurons ).clear( );
     std::get< 1 >( _unselectedNeurons ).clear( );
     std::get< 0 >( _selectedNeurons ).clear( );
     std::get< 1 >( _selectedNeurons ).clear( );
+    _renderQueue.clear( );
+    _renderPasses.clear( );
 
     _dataSet->close( );
 #ifdef NEUROTESSMESH_USE_SIMIL
@@ -202,6 +350,7 @@ namespace neurotessmesh
   void Scene::home( )
   {
     mode( Scene::VISUALIZATION );
+    clearEditMeshCache( );
     _editNeuron = nullptr;
     _editMesh = nullptr;
 
@@ -222,100 +371,418 @@ namespace neurotessmesh
   nlgeometry::AxisAlignedBoundingBox Scene::computeBoundingBox(
     const std::vector< unsigned int >& indices_ )
   {
-    Eigen::Array3f minimum =
-      Eigen::Array3f::Constant( std::numeric_limits< float >::max( ));
-    Eigen::Array3f maximum =
-      Eigen::Array3f::Constant( std::numeric_limits< float >::min( ));
+    return _neuronBounds.bounds( indices_ );
+  }
+
+  nlgeometry::AxisAlignedBoundingBox Scene::computeBoundingBox( )
+  {
+    return _neuronBounds.bounds( );
+  }
+
+  const NeuronBounds& Scene::neuronBounds( ) const
+  {
+    return _neuronBounds;
+  }
+
+  bool Scene::pickNeuron( int x_ , int y_ , int width_ , int height_ ,
+                          unsigned int& id_ )
+  {
+    // Only the edited neuron is shown while editing
+    if ( _mode == EDITION || width_ <= 0 || height_ <= 0 )
+      return false;
 
-    for ( const auto id: indices_ )
+    const Eigen::Matrix4f projection( _camera->camera( )->projectionMatrix( ));
+    const Eigen::Matrix4f view( _camera->camera( )->viewMatrix( ));
+    const Eigen::Matrix4f inverse = ( projection * view ).inverse( );
+
+    const float x = 2.0f * ( x_ + 0.5f ) / width_ - 1.0f;
+    const float y = 1.0f - 2.0f * ( y_ + 0.5f ) / height_;
+    const Eigen::Vector4f nearPoint = inverse * Eigen::Vector4f( x , y , -1.0f , 1.0f );
+    const Eigen::Vector4f farPoint = inverse * Eigen::Vector4f( x , y , 1.0f , 1.0f );
+
+    const Eigen::Vector3f origin = nearPoint.head< 3 >( ) / nearPoint.w( );
+    const Eigen::Vector3f direction =
+      ( farPoint.head< 3 >( ) / farPoint.w( ) - origin ).normalized( );
+
+    return _neuronPicker.pick( origin , direction , id_ );
+  }
+
+  std::vector< unsigned int > Scene::neuronsInRegion(
+    const std::vector< Eigen::Vector2f >& region_ , int width_ , int height_ )
+  {
+    if ( _mode == EDITION || region_.size( ) < 2 || width_ <= 0 || height_ <= 0 )
+      return std::vector< unsigned int >( );
+
+    // Region in normalized device coordinates
+    std::vector< Eigen::Vector2f > polygon;
+    polygon.reserve( region_.size( ));
+    for ( const auto& point: region_ )
+      polygon.emplace_back( 2.0f * point.x( ) / width_ - 1.0f ,
+                            1.0f - 2.0f * point.y( ) / height_ );
+
+    Eigen::Vector2f minimum = polygon.front( );
+    Eigen::Vector2f maximum = polygon.front( );
+    for ( const auto& point: polygon )
     {
-      const auto neuronMapIt = _dataSet->neurons( ).find( id );
-      if ( neuronMapIt != _dataSet->neurons( ).end( ))
+      minimum = minimum.cwiseMin( point );
+      maximum = maximum.cwiseMax( point );
+    }
+    if (( maximum - minimum ).minCoeff( ) <= 0.0f )
+      return std::vector< unsigned int >( );
+
+    // Frustum of the region bounds, extracted from the clip space limits
+    const Eigen::Matrix4f projection( _camera->camera( )->projectionMatrix( ));
+    const Eigen::Matrix4f view( _camera->camera( )->viewMatrix( ));
+    const Eigen::Matrix4f viewProjection = projection * view;
+    const Eigen::Vector4f x = viewProjection.row( 0 ).transpose( );
+    const Eigen::Vector4f y = viewProjection.row( 1 ).transpose( );
+    const Eigen::Vector4f z = viewProjection.row( 2 ).transpose( );
+    const Eigen::Vector4f w = viewProjection.row( 3 ).transpose( );
+
+    NeuronPicker::Planes planes;
+    planes.push_back( x - minimum.x( ) * w );
+    planes.push_back( maximum.x( ) * w - x );
+    planes.push_back( y - minimum.y( ) * w );
+    planes.push_back( maximum.y( ) * w - y );
+    planes.push_back( w + z );
+    planes.push_back( w - z );
+
+    if ( polygon.size( ) == 2 )
+      return _neuronPicker.inside( planes );
+
+    // Lasso: even-odd test of the projected soma against the polygon
+    return _neuronPicker.inside( planes ,
+      [ &viewProjection , &polygon ]( const Eigen::Vector3f& soma )
       {
-        const auto neuron = neuronMapIt->second;
-        auto morphology = neuron->morphology( );
-        if ( morphology )
+        const Eigen::Vector4f clip = viewProjection * soma.homogeneous( );
+        const Eigen::Vector2f point = clip.head< 2 >( ) / clip.w( );
+
+        bool inside = false;
+        for ( size_t i = 0 , j = polygon.size( ) - 1; i < polygon.size( ); j = i++ )
         {
-          const auto radius = morphology->soma( )->maxRadius( );
-          const auto center = morphology->soma( )->center( );
-          const Eigen::Vector4f position = neuron->transform( ) *
-                                     nsol::Vec4f( center.x( ) , center.y( ) ,
-                                                  center.z( ) , 1.0f );
-          Eigen::Array3f minVec( position.x( ) - radius ,
-                                 position.y( ) - radius ,
-                                 position.z( ) - radius );
-          Eigen::Array3f maxVec( position.x( ) + radius ,
-                                 position.y( ) + radius ,
-                                 position.z( ) + radius );
-          minimum = minimum.min( minVec );
-          maximum = maximum.max( maxVec );
+          const auto& a = polygon[ i ];
+          const auto& b = polygon[ j ];
+          if (( a.y( ) > point.y( )) != ( b.y( ) > point.y( )) &&
+              point.x( ) < ( b.x( ) - a.x( )) * ( point.y( ) - a.y( )) /
+                           ( b.y( ) - a.y( )) + a.x( ))
+            inside = !inside;
         }
-      }
-    }
-    return { minimum , maximum };
+        return inside;
+      });
   }
 
-  nlgeometry::AxisAlignedBoundingBox Scene::computeBoundingBox( )
+  std::vector< Eigen::Vector2f > Scene::somaPositions(
+    const std::vector< unsigned int >& ids_ , int width_ , int height_ ) const
   {
-    std::vector< unsigned int > indices;
-    for (const auto& neuronIt: _dataSet->neurons())
+    std::vector< Eigen::Vector2f > positions;
+    positions.reserve( ids_.size( ));
+
+    const Eigen::Matrix4f projection( _camera->camera( )->projectionMatrix( ));
+    const Eigen::Matrix4f view( _camera->camera( )->viewMatrix( ));
+    const Eigen::Matrix4f viewProjection = projection * view;
+    for ( const auto id: ids_ )
     {
-      indices.push_back( neuronIt.first );
+      const auto index = _neuronBounds.index( id );
+      if ( index < 0 )
+        continue;
+
+      const Eigen::Vector4f clip = viewProjection *
+        _neuronPicker.soma( static_cast< size_t >( index )).homogeneous( );
+      if ( clip.w( ) <= 0.0f )
+        continue;
+
+      positions.emplace_back(( clip.x( ) / clip.w( ) + 1.0f ) * 0.5f * width_ ,
+                             ( 1.0f - clip.y( ) / clip.w( )) * 0.5f * height_ );
     }
-    return computeBoundingBox( indices );
+    return positions;
+  }
+
+  const NeuronPicker& Scene::neuronPicker( ) const
+  {
+    return _neuronPicker;
   }
 
   void Scene::generateMeshes()
   {
+    // With a budget the visible meshes are generated first by update( ),
+    // instead of uploading all of them to evict them afterwards.
+    const bool eager = !_lazyMeshes && _residency.budget( ) == 0;
     for (const auto neuronIt: _dataSet->neurons( ))
     {
       auto morphology = neuronIt.second->morphology( );
       if ( morphology )
       {
-        if ( _neuronMeshes.find( morphology ) == _neuronMeshes.end( ))
-        {
-          auto simplifier = nsol::Simplifier::Instance( );
-          simplifier->adaptSoma( morphology );
-          simplifier->simplify( morphology ,
-                                nsol::Simplifier::DIST_NODES_RADIUS );
-
-          auto mesh = nlgenerator::MeshGenerator::generateMesh( morphology );
-          mesh->uploadGPU( _attribsFormat , nlgeometry::Facet::PATCHES );
-          mesh->clearCPUData( );
-          _neuronMeshes[ morphology ] = mesh;
-        }
+        if ( eager )
+          ensureMesh( morphology );
       }
       else
       {
         throw std::runtime_error( "Unable to load neuron morphology" );
       }
     }
+
+    if ( !eager )
+      createPlaceholder( );
+  }
+
+  void Scene::simplifyMorphology( nsol::NeuronMorphologyPtr morphology )
+  {
+    if ( _simplifiedMorphologies ||
+         _preparedMorphologies.find( morphology ) != _preparedMorphologies.end( ))
+      return;
+
+    auto simplifier = nsol::Simplifier::Instance( );
+    simplifier->adaptSoma( morphology );
+    simplifier->simplify( morphology , nsol::Simplifier::DIST_NODES_RADIUS );
+    _preparedMorphologies.insert( morphology );
+  }
+
+  void Scene::simplifyMorphologies( )
+  {
+    for ( const auto& neuronIt: _dataSet->neurons( ))
+    {
+      if ( neuronIt.second->morphology( ))
+        simplifyMorphology( neuronIt.second->morphology( ));
+    }
+  }
+
+  nlgeometry::MeshPtr Scene::ensureMesh( nsol::NeuronMorphologyPtr morphology )
+  {
+    const auto meshIt = _neuronMeshes.find( morphology );
+    if ( meshIt != _neuronMeshes.end( ))
+      return meshIt->second;
+
+    simplifyMorphology( morphology );
+
+    auto mesh = nlgenerator::MeshGenerator::generateMesh( morphology );
+    const auto bytes = meshGPUBytes( mesh , _attribsFormat.size( ));
+    mesh->uploadGPU( _attribsFormat , nlgeometry::Facet::PATCHES );
+    mesh->clearCPUData( );
+
+    _neuronMeshes[ morphology ] = mesh;
+    _residency.insert( morphology , bytes );
+
+    return mesh;
+  }
+
+  void Scene::releaseMesh( nsol::NeuronMorphologyPtr morphology )
+  {
+    const auto meshIt = _neuronMeshes.find( morphology );
+    if ( meshIt == _neuronMeshes.end( ))
+      return;
+
+    _activationTimestamps.erase( meshIt->second );
+    delete meshIt->second;
+    _neuronMeshes.erase( meshIt );
+
+    _residency.remove( morphology );
+  }
+
+  bool Scene::updateResidentMeshes( )
+  {
+    if ( !_dataSet || !_camera )
+      return false;
+
+    createPlaceholder( );
+    _residency.nextFrame( );
+
+    const Eigen::Matrix4f projection( _camera->camera( )->projectionMatrix( ));
+    const Eigen::Matrix4f view( _camera->camera( )->viewMatrix( ));
+    const Eigen::Vector3f eye = _camera->position( );
+    const auto planes = frustumPlanes( projection * view );
+
+    // Visible meshes are marked as used, visible neurons without mesh wait
+    // for generation after the selected ones. The visibility is tested with
+    // the full morphology bounds, neurites can cross the view with the soma
+    // out of it.
+    std::vector< nsol::NeuronMorphologyPtr > pending( _pendingMeshes );
+    for ( const auto& neuronIt: _dataSet->neurons( ))
+    {
+      const auto neuron = neuronIt.second;
+      const auto morphology = neuron->morphology( );
+      if ( !morphology ) continue;
+
+      // Neurons without bounds have no nodes to draw
+      const auto index = _neuronBounds.index( neuronIt.first );
+      if ( index < 0 ) continue;
+      const Eigen::Vector3f minimum =
+        _neuronBounds.minimum( static_cast< size_t >( index ));
+      const Eigen::Vector3f maximum =
+        _neuronBounds.maximum( static_cast< size_t >( index ));
+
+      const bool resident = _residency.resident( morphology );
+      if ( resident )
+        _residency.distance( morphology ,
+                             (( minimum + maximum ) * 0.5f - eye ).norm( ));
+
+      if ( !boxInFrustum( planes , minimum , maximum ))
+        continue;
+
+      if ( resident )
+        _residency.touch( morphology );
+      else
+        pending.push_back( morphology );
+    }
+
+    const auto editMorphology =
+      _editNeuron ? _editNeuron->morphology( ) : nullptr;
+    trimEditMeshCache( );
+    const auto evicted = _residency.evict( editMorphology );
+    for ( const auto morphology: evicted )
+      releaseMesh( morphology );
+    bool changed = !evicted.empty( );
+
+    unsigned int generated = 0;
+    _meshesPending = false;
+    for ( const auto morphology: pending )
+    {
+      if ( _neuronMeshes.find( morphology ) != _neuronMeshes.end( )) continue;
+      if ( _residency.full( )) break;
+      if ( generated >= LAZY_MESHES_PER_FRAME )
+      {
+        _meshesPending = true;
+        break;
+      }
+
+      ensureMesh( morphology );
+      ++generated;
+      changed = true;
+    }
+
+    _pendingMeshes.erase(
+      std::remove_if( _pendingMeshes.begin( ) , _pendingMeshes.end( ) ,
+                      [ this ]( nsol::NeuronMorphologyPtr morphology )
+                      {
+                        return _neuronMeshes.find( morphology ) !=
+                               _neuronMeshes.end( );
+                      }) , _pendingMeshes.end( ));
+
+    return changed;
+  }
+
+  void Scene::createPlaceholder( )
+  {
+    if ( _placeholderMesh )
+      return;
+
+    auto soma = new nsol::Soma( );
+    soma->addNode( new nsol::Node( nsol::Vec3f( 0.0f , 0.0f , 0.0f ) , 0 ,
+                                   1.0f ));
+    _placeholderMorphology = new nsol::NeuronMorphology( soma );
+
+    _placeholderMesh =
+      nlgenerator::MeshGenerator::generateMesh( _placeholderMorphology );
+    _placeholderMesh->uploadGPU( _attribsFormat , nlgeometry::Facet::PATCHES );
+    _placeholderMesh->clearCPUData( );
+  }
+
+  bool Scene::placeholderModel( const nsol::NeuronPtr neuron ,
+                               Eigen::Matrix4f& model_ ) const
+  {
+    const auto soma = neuron->morphology( )->soma( );
+    if ( !soma )
+      return false;
+
+    const Eigen::Affine3f model = Eigen::Translation3f( soma->center( )) *
+                                  Eigen::Scaling( soma->maxRadius( ));
+
+    model_ = neuron->transform( ) * model.matrix( );
+    return true;
+  }
+
+  void Scene::lazyMeshGeneration( bool lazy_ )
+  {
+    if ( _lazyMeshes == lazy_ )
+      return;
+
+    _lazyMeshes = lazy_;
+    generateMeshes( );
+    conformRenderTuples( );
+  }
+
+  bool Scene::lazyMeshGeneration( ) const
+  {
+    return _lazyMeshes;
+  }
+
+  void Scene::meshMemoryLimit( size_t bytes_ )
+  {
+    const bool unlimited = _residency.budget( ) > 0 && bytes_ == 0;
+    _residency.budget( bytes_ );
+    trimEditMeshCache( );
+
+    // Restore the meshes evicted while the budget was active.
+    if ( unlimited && !_lazyMeshes && _dataSet )
+    {
+      generateMeshes( );
+      conformRenderTuples( );
+    }
+  }
+
+  size_t Scene::meshMemoryLimit( ) const
+  {
+    return _residency.budget( );
+  }
+
+  size_t Scene::meshMemoryUsage( ) const
+  {
+    return _residency.usage( );
+  }
+
+  void Scene::meshEvictionPolicy(
+    MeshResidencyManager::EvictionPolicy policy_ )
+  {
+    _residency.policy( policy_ );
+  }
+
+  const MeshResidencyManager& Scene::meshResidency( ) const
+  {
+    return _residency;
+  }
+
+  bool Scene::meshesPending( ) const
+  {
+    return _meshesPending;
   }
 
   void Scene::paintUnselectedSoma( bool paint_ )
   {
     _paintUnselectedSoma = paint_;
+    _renderPassesDirty = true;
+    ++_version;
   }
 
   void Scene::paintUnselectedNeurites( bool paint_ )
   {
     _paintUnselectedNeurites = paint_;
+    _renderPassesDirty = true;
+    ++_version;
   }
 
   void Scene::paintSelectedSoma( bool paint_ )
   {
     _paintSelectedSoma = paint_;
+    _renderPassesDirty = true;
+    ++_version;
   }
 
   void Scene::paintSelectedNeurites( bool paint_ )
   {
     _paintSelectedNeurites = paint_;
+    _renderPassesDirty = true;
+    ++_version;
   }
 
   void Scene::levelOfDetail( float lod_ )
   {
     if ( _renderer )
       _renderer->lod( ) = lod_;
+    ++_version;
+  }
+
+  float Scene::levelOfDetail( ) const
+  {
+    return _renderer ? _renderer->lod( ) : 1.0f;
   }
 
   void Scene::maximumDistance( float maximumDistance_ )
@@ -323,12 +790,14 @@ namespace neurotessmesh
     if ( _renderer )
       _renderer->maximumDistance( ) =
         maximumDistance_ * _camera->camera( )->farPlane( );
+    ++_version;
   }
 
   void Scene::subdivisionCriteria(
     nlrender::Renderer::TTessCriteria subdivisionCriteria_ )
   {
     _renderer->tessCriteria( subdivisionCriteria_ );
+    ++_version;
   }
 
   std::vector< unsigned int > Scene::neuronIndices( )
@@ -352,14 +821,19 @@ namespace neurotessmesh
     const auto neuronIt = _dataSet->neurons( ).find( id_ );
     if ( neuronIt != _dataSet->neurons( ).end( ))
     {
+      clearEditMeshCache( );
       _editNeuron = neuronIt->second;
       if ( _editNeuron )
       {
-        const auto meshIt = _neuronMeshes.find( _editNeuron->morphology( ));
-        if ( meshIt != _neuronMeshes.end( ))
+        const auto morphology = _editNeuron->morphology( );
+        const bool hadMesh =
+          _neuronMeshes.find( morphology ) != _neuronMeshes.end( );
+        if ( morphology )
         {
+          _editMesh = ensureMesh( morphology );
+          if ( !hadMesh )
+            conformRenderTuples( );
 
-          _editMesh = meshIt->second;
           mode( Scene::EDITION );
           std::vector< unsigned int > indices = { id_ };
           const auto aabb = computeBoundingBox( indices );
@@ -383,20 +857,153 @@ namespace neurotessmesh
     const float alphaRadius_ ,
     const std::vector< float >& alphaNeurites_ )
   {
-    if ( isEditNeuronMeshExtraction( ))
+    if ( isEditNeuronMeshExtraction( ) &&
+         !useCachedEditNeuronMesh( alphaRadius_ , alphaNeurites_ ))
     {
+      const auto morphology = _editNeuron->morphology( );
       auto mesh = nlgenerator::MeshGenerator::generateMesh(
-        _editNeuron->morphology( ) , alphaRadius_ , alphaNeurites_ );
+        morphology , alphaRadius_ , alphaNeurites_ );
       if ( mesh )
+        replaceEditNeuronMesh( morphology , mesh ,
+                               alphaRadius_ , alphaNeurites_ );
+    }
+  }
+
+  nsol::NeuronMorphologyPtr Scene::editNeuronMorphology( ) const
+  {
+    return _editNeuron ? _editNeuron->morphology( ) : nullptr;
+  }
+
+  bool Scene::replaceEditNeuronMesh( nsol::NeuronMorphologyPtr morphology_ ,
+                                     nlgeometry::MeshPtr mesh_ ,
+                                     float alphaRadius_ ,
+                                     const std::vector< float >& alphaNeurites_ )
+  {
+    if ( !isEditNeuronMeshExtraction( ) ||
+         _editNeuron->morphology( ) != morphology_ )
+    {
+      delete mesh_;
+      return false;
+    }
+
+    const auto bytes = meshGPUBytes( mesh_ , _attribsFormat.size( ));
+    mesh_->uploadGPU( _attribsFormat , nlgeometry::Facet::PATCHES );
+    mesh_->clearCPUData( );
+
+    swapEditMesh( EditMeshEntry{ alphaRadius_ , alphaNeurites_ , mesh_ , bytes });
+
+    return true;
+  }
+
+  bool Scene::useCachedEditNeuronMesh(
+    float alphaRadius_ , const std::vector< float >& alphaNeurites_ )
+  {
+    if ( !isEditNeuronMeshExtraction( ))
+      return false;
+
+    // The parameters come from the UI, values rounded differently are the
+    // same mesh.
+    auto sameAlpha = []( float a , float b )
+    {
+      return std::abs( a - b ) <= EDIT_MESH_ALPHA_TOLERANCE;
+    };
+    auto sameParameters = [ & ]( const EditMeshEntry& entry )
+    {
+      return sameAlpha( entry.alphaRadius , alphaRadius_ ) &&
+             entry.alphaNeurites.size( ) == alphaNeurites_.size( ) &&
+             std::equal( entry.alphaNeurites.begin( ) ,
+                         entry.alphaNeurites.end( ) ,
+                         alphaNeurites_.begin( ) , sameAlpha );
+    };
+
+    if ( _editParametersValid && sameParameters( _editParameters ))
+      return true;
+
+    const auto cached = std::find_if( _editMeshCache.begin( ) ,
+                                      _editMeshCache.end( ) , sameParameters );
+    if ( cached == _editMeshCache.end( ))
+      return false;
+
+    const auto entry = *cached;
+    _editMeshCache.erase( cached );
+    trimEditMeshCache( );
+    swapEditMesh( entry );
+
+    return true;
+  }
+
+  void Scene::swapEditMesh( const EditMeshEntry& entry )
+  {
+    // Every neuron sharing the morphology draws the new mesh, the render
+    // lists keep their order so the colors stay valid.
+    const auto oldMesh = _editMesh;
+    for ( auto neurons: { &_unselectedNeurons , &_selectedNeurons })
+    {
+      auto& meshes = std::get< 0 >( *neurons );
+      std::replace( meshes.begin( ) , meshes.end( ) , oldMesh , entry.mesh );
+    }
+
+    const auto timestamp = _activationTimestamps.find( oldMesh );
+    if ( timestamp != _activationTimestamps.end( ))
+    {
+      const auto time = timestamp->second;
+      _activationTimestamps.erase( timestamp );
+      _activationTimestamps[ entry.mesh ] = time;
+    }
+
+    // The replaced mesh can only be reused if its parameters are known.
+    if ( _editParametersValid )
+    {
+      _editParameters.mesh = oldMesh;
+      _editMeshCache.push_front( _editParameters );
+      if ( _editMeshCache.size( ) > EDIT_MESH_CACHE_SIZE )
       {
-        mesh->uploadGPU( _attribsFormat , nlgeometry::Facet::PATCHES );
-        mesh->clearCPUData( );
-        delete _editMesh;
-        _editMesh = mesh;
-        _neuronMeshes[ _editNeuron->morphology( ) ] = mesh;
-        conformRenderTuples( );
+        delete _editMeshCache.back( ).mesh;
+        _editMeshCache.pop_back( );
       }
     }
+    else
+      delete oldMesh;
+
+    const auto morphology = _editNeuron->morphology( );
+    _editMesh = entry.mesh;
+    _neuronMeshes[ morphology ] = entry.mesh;
+    _residency.insert( morphology , entry.bytes );
+
+    _editParameters = entry;
+    _editParameters.mesh = nullptr;
+    _editParametersValid = true;
+    trimEditMeshCache( );
+    _clippingDirty = true;
+    _renderPassesDirty = true;
+    ++_version;
+  }
+
+  void Scene::clearEditMeshCache( )
+  {
+    for ( const auto& entry: _editMeshCache )
+      delete entry.mesh;
+    _editMeshCache.clear( );
+    _editParametersValid = false;
+    _residency.reserve( 0 );
+  }
+
+  void Scene::trimEditMeshCache( )
+  {
+    size_t bytes = 0;
+    for ( const auto& entry: _editMeshCache )
+      bytes += entry.bytes;
+    _residency.reserve( bytes );
+
+    // Visible meshes have priority over the cached ones
+    while ( !_editMeshCache.empty( ) && _residency.budget( ) > 0 &&
+            _residency.usage( ) > _residency.budget( ))
+    {
+      delete _editMeshCache.back( ).mesh;
+      bytes -= _editMeshCache.back( ).bytes;
+      _editMeshCache.pop_back( );
+      _residency.reserve( bytes );
+    }
   }
 
   bool Scene::isEditNeuronMeshExtraction( )
@@ -414,39 +1021,479 @@ namespace neurotessmesh
     delete extractedMesh;
   }
 
+  nlgeometry::MeshPtr Scene::extractNeuronMesh( unsigned int id_ )
+  {
+    const auto neuronIt = _dataSet->neurons( ).find( id_ );
+    if ( neuronIt == _dataSet->neurons( ).end( ) ||
+         !neuronIt->second->morphology( ))
+      return nullptr;
+
+    const auto neuron = neuronIt->second;
+    const auto morphology = neuron->morphology( );
+    const bool resident = _neuronMeshes.find( morphology ) != _neuronMeshes.end( );
+    const auto mesh = ensureMesh( morphology );
+    const bool selected = _selectedIndices.find( id_ ) != _selectedIndices.end( );
+
+    const auto extracted = _renderer->extract(
+      mesh , neuron->transform( ) ,
+      selected ? _paintSelectedSoma : _paintUnselectedSoma ,
+      selected ? _paintSelectedNeurites : _paintUnselectedNeurites );
+
+    // Meshes generated only for the export don't stay resident, the render
+    // tuples never referenced them.
+    if ( !resident )
+      releaseMesh( morphology );
+
+    return extracted;
+  }
+
+  const std::set< unsigned int >& Scene::selectedIndices( ) const
+  {
+    return _selectedIndices;
+  }
+
   void Scene::conformRenderTuples()
   {
     nlgeometry::Meshes unselectedMeshes;
     std::vector< Eigen::Matrix4f > unselectedModels;
     nlgeometry::Meshes selectedMeshes;
     std::vector< Eigen::Matrix4f > selectedModels;
+    _unselectedPositions.clear( );
+    _selectedPositions.clear( );
+    _unselectedIds.clear( );
+    _selectedIds.clear( );
     for ( const auto neuronIt: _dataSet->neurons( ))
     {
       const auto neuron = neuronIt.second;
+      nlgeometry::MeshPtr mesh = nullptr;
+      Eigen::Matrix4f model;
+
       auto meshIt = _neuronMeshes.find( neuron->morphology( ));
       if ( meshIt != _neuronMeshes.end( ))
+      {
+        mesh = meshIt->second;
+        model = neuron->transform( );
+      }
+      else if ( _placeholderMesh && neuron->morphology( ) &&
+                placeholderModel( neuron , model ))
+      {
+        mesh = _placeholderMesh;
+      }
+
+      if ( mesh )
       {
         if ( _selectedIndices.find( neuronIt.first ) != _selectedIndices.end( ))
         {
-          selectedMeshes.push_back( meshIt->second );
-          selectedModels.push_back( neuron->transform( ));
+          selectedMeshes.push_back( mesh );
+          selectedModels.push_back( model );
+          _selectedPositions.push_back( _neuronBounds.index( neuronIt.first ));
+          _selectedIds.push_back( neuronIt.first );
         }
         else
         {
-          unselectedMeshes.push_back( meshIt->second );
-          unselectedModels.push_back( neuron->transform( ));
+          unselectedMeshes.push_back( mesh );
+          unselectedModels.push_back( model );
+          _unselectedPositions.push_back( _neuronBounds.index( neuronIt.first ));
+          _unselectedIds.push_back( neuronIt.first );
         }
       }
     }
+    // Counting sort of the queue items by mesh, in order of appearance
+    const size_t unselectedCount = unselectedMeshes.size( );
+    const size_t count = unselectedCount + selectedMeshes.size( );
+    auto itemMesh = [ & ]( size_t item )
+    {
+      return item < unselectedCount ? unselectedMeshes[ item ] :
+        selectedMeshes[ item - unselectedCount ];
+    };
+    std::unordered_map< nlgeometry::MeshPtr , size_t > groups;
+    std::vector< size_t > itemGroups( count );
+    std::vector< size_t > offsets;
+    for ( size_t item = 0; item < count; ++item )
+    {
+      const auto group = groups.emplace( itemMesh( item ) , groups.size( ));
+      if ( group.second )
+        offsets.push_back( 0 );
+      itemGroups[ item ] = group.first->second;
+      ++offsets[ group.first->second ];
+    }
+    size_t offset = 0;
+    for ( auto& groupOffset: offsets )
+    {
+      const size_t size = groupOffset;
+      groupOffset = offset;
+      offset += size;
+    }
+    _renderQueue.resize( count );
+    for ( size_t item = 0; item < count; ++item )
+      _renderQueue[ offsets[ itemGroups[ item ]]++ ] = item;
+
     _unselectedNeurons = std::make_tuple( unselectedMeshes , unselectedModels );
     _selectedNeurons = std::make_tuple( selectedMeshes , selectedModels );
+    rebuildNeuronsColors( );
+  }
+
+  void Scene::clippingPlanes( const NeuronPicker::Planes& planes_ )
+  {
+    _clippingPlanes = planes_;
+    _neuronPicker.clippingPlanes( planes_ );
+    _clippingDirty = true;
+    _renderPassesDirty = true;
+    ++_version;
+  }
+
+  const NeuronPicker::Planes& Scene::clippingPlanes( ) const
+  {
+    return _clippingPlanes;
+  }
+
+  void Scene::slab( unsigned int axis_ , float minimum_ , float maximum_ )
+  {
+    Eigen::Vector4f lower = Eigen::Vector4f::Zero( );
+    lower[ axis_ ] = 1.0f;
+    lower.w( ) = -minimum_;
+    Eigen::Vector4f upper = Eigen::Vector4f::Zero( );
+    upper[ axis_ ] = -1.0f;
+    upper.w( ) = maximum_;
+
+    NeuronPicker::Planes planes;
+    planes.push_back( lower );
+    planes.push_back( upper );
+    clippingPlanes( planes );
+  }
+
+  void Scene::updateClipping( )
+  {
+    _clippingDirty = false;
+
+    // Neurons without bounds are kept
+    auto clip = [ this ]( const std::vector< long >& positions ,
+                          std::vector< size_t >& entries )
+    {
+      entries.clear( );
+      for ( size_t i = 0; i < positions.size( ); ++i )
+        if ( positions[ i ] < 0 ||
+             !_neuronPicker.culled( static_cast< size_t >( positions[ i ])))
+          entries.push_back( i );
+    };
+
+    clip( _unselectedPositions , _clippedUnselectedEntries );
+    clip( _selectedPositions , _clippedSelectedEntries );
+    gatherNeurons( _unselectedNeurons , _unselectedColors ,
+                   _clippedUnselectedEntries , _clippedUnselectedNeurons ,
+                   _clippedUnselectedColors );
+    gatherNeurons( _selectedNeurons , _selectedColors ,
+                   _clippedSelectedEntries , _clippedSelectedNeurons ,
+                   _clippedSelectedColors );
+  }
+
+  void Scene::renderNeurons( const std::vector< size_t >* unselectedEntries_ ,
+                             const std::vector< size_t >* selectedEntries_ )
+  {
+    // A translucent context is composited over the selected neurons,
+    // otherwise both sets are drawn from the render queue.
+    if ( _unselectedAlpha >= 1.0f )
+    {
+      std::vector< RenderPass > passes;
+      if ( unselectedEntries_ || selectedEntries_ )
+        buildRenderPasses( unselectedEntries_ , selectedEntries_ , passes );
+      auto& renderPasses =
+        unselectedEntries_ || selectedEntries_ ? passes : _renderPasses;
+
+#ifdef NEUROTESSMESH_USE_SIMIL
+      const size_t unselectedCount = std::get< 0 >( _unselectedNeurons ).size( );
+      const float timeStamp = _simulationPlayer ? _simulationPlayer->currentTime() : 0.f;
+      const auto activationColors = _simulationPlayer ?
+        calculateUnselectedColors(timeStamp) : std::vector< Eigen::Vector3f >( );
+#endif
+      for ( auto& pass: renderPasses )
+      {
+#ifdef NEUROTESSMESH_USE_SIMIL
+        if ( _simulationPlayer )
+        {
+          auto passColors = pass.colors;
+          for ( size_t i = 0; i < pass.items.size( ); ++i )
+            if ( pass.items[ i ] < unselectedCount &&
+                 pass.items[ i ] < activationColors.size( ))
+              passColors[ i ] = activationColors[ pass.items[ i ]];
+          _renderer->render( std::get< 0 >( pass.neurons ) ,
+                             std::get< 1 >( pass.neurons ) ,
+                             pass.colors , passColors , true ,
+                             pass.soma , pass.neurites );
+          continue;
+        }
+#endif
+        _renderer->render( std::get< 0 >( pass.neurons ) ,
+                           std::get< 1 >( pass.neurons ) ,
+                           pass.colors , pass.colors , true ,
+                           pass.soma , pass.neurites );
+      }
+      return;
+    }
+
+    const bool clipping = !_clippingPlanes.empty( );
+
+    NeuronMeshes unselectedNeurons , selectedNeurons;
+    std::vector< Eigen::Vector3f > unselectedColors , selectedColors;
+    if ( unselectedEntries_ )
+      gatherNeurons( _unselectedNeurons , _unselectedColors , *unselectedEntries_ ,
+                     unselectedNeurons , unselectedColors );
+    if ( selectedEntries_ )
+      gatherNeurons( _selectedNeurons , _selectedColors , *selectedEntries_ ,
+                     selectedNeurons , selectedColors );
+
+    auto& unselected = unselectedEntries_ ? unselectedNeurons :
+      ( clipping ? _clippedUnselectedNeurons : _unselectedNeurons );
+    auto& unselectedPalette = unselectedEntries_ ? unselectedColors :
+      ( clipping ? _clippedUnselectedColors : _unselectedColors );
+    auto& selected = selectedEntries_ ? selectedNeurons :
+      ( clipping ? _clippedSelectedNeurons : _selectedNeurons );
+    auto& selectedPalette = selectedEntries_ ? selectedColors :
+      ( clipping ? _clippedSelectedColors : _selectedColors );
+
+    _renderer->render( std::get< 0 >( selected ) ,
+                       std::get< 1 >( selected ) ,
+                       selectedPalette, selectedPalette, true , _paintSelectedSoma ,
+                       _paintSelectedNeurites );
+
+    if ( _unselectedAlpha <= 0.0f ||
+         !( _paintUnselectedSoma || _paintUnselectedNeurites ) ||
+         !_unselectedLayer.begin( ))
+      return;
+
+#ifdef NEUROTESSMESH_USE_SIMIL
+    const float timeStamp = _simulationPlayer ? _simulationPlayer->currentTime() : 0.f;
+    auto activationColors = _simulationPlayer ?
+      calculateUnselectedColors(timeStamp) : _unselectedColors;
+    const auto activationEntries = unselectedEntries_ ? unselectedEntries_ :
+      ( clipping ? &_clippedUnselectedEntries : nullptr );
+    if ( activationEntries )
+    {
+      std::vector< Eigen::Vector3f > entryColors;
+      entryColors.reserve( activationEntries->size( ));
+      for ( const auto entry: *activationEntries )
+        if ( entry < activationColors.size( ))
+          entryColors.push_back( activationColors[ entry ]);
+      activationColors.swap( entryColors );
+    }
+    _renderer->render( std::get< 0 >( unselected ) ,
+                       std::get< 1 >( unselected ) ,
+                       unselectedPalette, activationColors , true ,
+                       _paintUnselectedSoma ,
+                       _paintUnselectedNeurites );
+#else
+    _renderer->render( std::get< 0 >( unselected ) ,
+                       std::get< 1 >( unselected ) ,
+                       unselectedPalette, unselectedPalette, true ,
+                       _paintUnselectedSoma , _paintUnselectedNeurites );
+#endif
+
+    _unselectedLayer.end( );
+    _unselectedLayer.composite( _unselectedAlpha );
+  }
+
+  void Scene::buildRenderPasses( const std::vector< size_t >* unselectedEntries_ ,
+                                 const std::vector< size_t >* selectedEntries_ ,
+                                 std::vector< RenderPass >& passes_ ) const
+  {
+    passes_.clear( );
+
+    const size_t unselectedCount = std::get< 0 >( _unselectedNeurons ).size( );
+    const size_t selectedCount = std::get< 0 >( _selectedNeurons ).size( );
+    if ( _renderQueue.size( ) != unselectedCount + selectedCount )
+      return;
+
+    // Queue items drawn, all of a set if it has no entries
+    std::vector< bool > drawn;
+    if ( unselectedEntries_ || selectedEntries_ )
+    {
+      drawn.assign( _renderQueue.size( ) , false );
+      if ( unselectedEntries_ )
+        for ( const auto entry: *unselectedEntries_ )
+          drawn[ entry ] = true;
+      else
+        std::fill( drawn.begin( ) , drawn.begin( ) + unselectedCount , true );
+      if ( selectedEntries_ )
+        for ( const auto entry: *selectedEntries_ )
+          drawn[ unselectedCount + entry ] = true;
+      else
+        std::fill( drawn.begin( ) + unselectedCount , drawn.end( ) , true );
+    }
+
+    auto addPass = [ & ]( bool soma , bool neurites , bool unselected ,
+                          bool selected )
+    {
+      if ( !unselected && !selected )
+        return;
+
+      RenderPass pass;
+      pass.soma = soma;
+      pass.neurites = neurites;
+      for ( const auto item: _renderQueue )
+      {
+        const bool isSelected = item >= unselectedCount;
+        if (( isSelected ? !selected : !unselected ) ||
+            ( !drawn.empty( ) && !drawn[ item ]))
+          continue;
+
+        const size_t entry = isSelected ? item - unselectedCount : item;
+        const auto& neurons = isSelected ? _selectedNeurons : _unselectedNeurons;
+        const auto& colors = isSelected ? _selectedColors : _unselectedColors;
+        std::get< 0 >( pass.neurons ).push_back( std::get< 0 >( neurons )[ entry ]);
+        std::get< 1 >( pass.neurons ).push_back( std::get< 1 >( neurons )[ entry ]);
+        pass.colors.push_back( entry < colors.size( ) ? colors[ entry ] :
+                               ( isSelected ? _selectedColor : _unselectedColor ));
+        pass.items.push_back( item );
+      }
+      if ( !pass.items.empty( ))
+        passes_.push_back( std::move( pass ));
+    };
+
+    if ( _paintSelectedSoma == _paintUnselectedSoma &&
+         _paintSelectedNeurites == _paintUnselectedNeurites )
+    {
+      if ( _paintSelectedSoma || _paintSelectedNeurites )
+        addPass( _paintSelectedSoma , _paintSelectedNeurites , true , true );
+    }
+    else
+    {
+      addPass( true , false , _paintUnselectedSoma , _paintSelectedSoma );
+      addPass( false , true , _paintUnselectedNeurites , _paintSelectedNeurites );
+    }
+  }
+
+  void Scene::unselectedAlpha( float alpha_ )
+  {
+    _unselectedAlpha = std::min( 1.0f , std::max( 0.0f , alpha_ ));
+    ++_version;
+  }
+
+  float Scene::unselectedAlpha( ) const
+  {
+    return _unselectedAlpha;
+  }
+
+  void Scene::renderOccluded( const Eigen::Matrix4f& viewProjection_ )
+  {
+    const bool clipping = !_clippingPlanes.empty( );
+    const auto previous = std::move( _occlusionVisible );
+
+    // Entries of the render tuples not clipped and passing the given test
+    // of their bounds position. Neurons without bounds are always drawn in
+    // the first pass.
+    auto entries = [ clipping ]( const std::vector< long >& positions ,
+                                 const std::vector< size_t >& clipped ,
+                                 const std::function< bool( long ) >& test )
+    {
+      std::vector< size_t > result;
+      if ( clipping )
+      {
+        for ( const auto entry: clipped )
+          if ( test( positions[ entry ]))
+            result.push_back( entry );
+      }
+      else
+      {
+        for ( size_t entry = 0; entry < positions.size( ); ++entry )
+          if ( test( positions[ entry ]))
+            result.push_back( entry );
+      }
+      return result;
+    };
+
+    // First pass: neurons visible in the previous frame, all the first time
+    auto wasVisible = [ &previous ]( long position )
+    {
+      return position < 0 || static_cast< size_t >( position ) >= previous.size( ) ||
+             previous[ static_cast< size_t >( position )];
+    };
+    auto unselected = entries( _unselectedPositions , _clippedUnselectedEntries ,
+                               wasVisible );
+    auto selected = entries( _selectedPositions , _clippedSelectedEntries ,
+                             wasVisible );
+
+    // Depth pyramid of the newest frame read back, a frame behind, the
+    // bounds hierarchy is tested against it to find the current visible set.
+    _depthReadback.collect( _occlusionCuller );
+    _occlusionVisible = _neuronPicker.select(
+      [ this ]( const Eigen::Vector3f& minimum , const Eigen::Vector3f& maximum )
+      {
+        return !_occlusionCuller.occluded( minimum , maximum );
+      });
+
+    // Second pass: neurons disoccluded in this frame. The depth tested is
+    // read back from previous frames, so both passes are drawn together and
+    // the translucent context layer is composited once.
+    auto isNew = [ this , &wasVisible ]( long position )
+    {
+      return !wasVisible( position ) &&
+             _occlusionVisible[ static_cast< size_t >( position )];
+    };
+    auto merge = [ ]( std::vector< size_t >& first ,
+                      const std::vector< size_t >& second )
+    {
+      const auto middle = first.insert( first.end( ) , second.begin( ) ,
+                                        second.end( ));
+      std::inplace_merge( first.begin( ) , middle , first.end( ));
+    };
+    merge( unselected , entries( _unselectedPositions ,
+                                 _clippedUnselectedEntries , isNew ));
+    merge( selected , entries( _selectedPositions , _clippedSelectedEntries ,
+                               isNew ));
+    renderNeurons( &unselected , &selected );
+
+    // Without depth every neuron is kept, as the culler does when cleared
+    const bool read = _depthReadback.read( viewProjection_ );
+    if ( !read )
+      _occlusionCuller.clear( );
+
+    // The visible set still changes while the depth tested is older than
+    // the view, the next frames have to be rendered until it settles.
+    _occlusionPending = _occlusionVisible != previous ||
+      ( read && !_occlusionCuller.current( viewProjection_ ));
+  }
+
+  void Scene::occlusionCulling( bool occlusionCulling_ )
+  {
+    _occlusionCulling = occlusionCulling_;
+    ++_version;
+    _occlusionVisible.clear( );
+    _occlusionCuller.clear( );
+    _occlusionPending = false;
+  }
+
+  bool Scene::occlusionCulling( ) const
+  {
+    return _occlusionCulling;
+  }
+
+  bool Scene::occlusionPending( ) const
+  {
+    return _occlusionCulling && _occlusionPending;
   }
 
   void Scene::changeSelectedIndices(const std::vector< unsigned int >& indices_ )
   {
     _selectedIndices = std::set<unsigned int>(indices_.begin(), indices_.end());
+
+    // Selected meshes are only queued here, this can be called without a
+    // current context. update( ) generates them first.
+    if ( _lazyMeshes )
+    {
+      _pendingMeshes.clear( );
+      for ( const auto id: _selectedIndices )
+      {
+        const auto neuronIt = _dataSet->neurons( ).find( id );
+        if ( neuronIt == _dataSet->neurons( ).end( ) ||
+             !neuronIt->second->morphology( ))
+          continue;
+        const auto morphology = neuronIt->second->morphology( );
+        if ( _neuronMeshes.find( morphology ) == _neuronMeshes.end( ))
+          _pendingMeshes.push_back( morphology );
+      }
+    }
+
     conformRenderTuples();
-    rebuildNeuronsColors();
   }
 
   void Scene::focusOnIndices(const std::vector< unsigned int >& indices_)
@@ -568,21 +1615,20 @@ namespace neurotessmesh
   {
     _selectedColors.clear();
     _unselectedColors.clear();
+    _clippingDirty = true;
+    _renderPassesDirty = true;
+    ++_version;
     if(!_dataSet) return;
 
-    for(const auto &neuron: _dataSet->neurons())
-    {
-      const auto color = neuronColor(neuron.first);
+    // Only the neurons with a render tuple entry get a color, so both stay
+    // aligned when lazy or budgeted meshes leave some neurons out.
+    _selectedColors.reserve(_selectedIds.size());
+    for(const auto id: _selectedIds)
+      _selectedColors.push_back(neuronColor(id));
 
-      if(_selectedIndices.find(neuron.first) != _selectedIndices.end())
-      {
-        _selectedColors.push_back(color);
-      }
-      else
-      {
-        _unselectedColors.push_back(color);
-      }
-    }
+    _unselectedColors.reserve(_unselectedIds.size());
+    for(const auto id: _unselectedIds)
+      _unselectedColors.push_back(neuronColor(id));
   }
 
   Eigen::Vector3f Scene::neuronColor(const unsigned int id)
@@ -28,11 +28,20 @@
 #include <nlrender/nlrender.h>
 
 #include <neurotessmesh/api.h>
+#include "MeshResidencyManager.h"
+#include "NeuronBounds.h"
+#include "NeuronPicker.h"
+#include "OcclusionCuller.h"
+#include "DepthReadback.h"
+#include "TranslucentLayer.h"
 #ifdef NEUROTESSMESH_USE_SIMIL
   #include <simil/simil.h>
 #endif
 #include <QPalette>
 
+#include <list>
+#include <unordered_set>
+
 class QColor;
 
 typedef std::vector< std::pair< float , Eigen::Vector3f >> Gradient;
@@ -70,7 +79,9 @@ namespace neurotessmesh
       NeuronMeshes;
 
     /**
-     * Default constructor
+     * Default constructor. The mesh memory budget and eviction policy are
+     * applied before generating the meshes, with a budget they are
+     * generated as they become visible
      */
     NEUROTESSMESH_API
     explicit Scene( reto::OrbitalCameraController* camera = nullptr,
@@ -78,7 +89,11 @@ namespace neurotessmesh
 #ifdef NEUROTESSMESH_USE_SIMIL
                     , simil::SpikesPlayer* player = nullptr
 #endif
-                    );
+                    , bool simplifiedMorphologies = false
+                    , bool lazyMeshes = false
+                    , size_t meshMemoryLimit = 0
+                    , MeshResidencyManager::EvictionPolicy meshEvictionPolicy =
+                        MeshResidencyManager::LEAST_RECENTLY_USED );
 
     /**
      * Default destructor
@@ -126,6 +141,21 @@ namespace neurotessmesh
     NEUROTESSMESH_API
     void render( );
 
+    /**
+     * Method to render the scene with the given projection instead of the
+     * camera one, used to render tiles of bigger images
+     * @param projection_ projection matrix
+     */
+    NEUROTESSMESH_API
+    void render( const Eigen::Matrix4f& projection_ );
+
+    /**
+     * Method to get the scene version, increased by every change that
+     * modifies the rendered image apart from the camera
+     * @return scene version
+     */
+    unsigned long version( ) const;
+
     /**
      * Method to close and deleted data from dataSet
      */
@@ -162,11 +192,193 @@ namespace neurotessmesh
     nlgeometry::AxisAlignedBoundingBox computeBoundingBox( );
 
     /**
-     * Method to generate the meshes associated to the loaded neurons
+     * Method to get the precomputed world bounding boxes of the neurons
+     * @return neuron bounding boxes
+     */
+    NEUROTESSMESH_API
+    const NeuronBounds& neuronBounds( ) const;
+
+    /**
+     * Method to find the neuron under a viewport position
+     * @param x_ horizontal position in pixels from the left
+     * @param y_ vertical position in pixels from the top
+     * @param width_ viewport width
+     * @param height_ viewport height
+     * @param id_ id of the picked neuron
+     * @return true if a neuron was picked
+     */
+    NEUROTESSMESH_API
+    bool pickNeuron( int x_ , int y_ , int width_ , int height_ ,
+                     unsigned int& id_ );
+
+    /**
+     * Method to find the neurons whose soma is inside a viewport region
+     * @param region_ region vertices in pixels from the top left corner,
+     * two vertices are the opposite corners of a rectangle
+     * @param width_ viewport width
+     * @param height_ viewport height
+     * @return sorted ids of the neurons inside the region
+     */
+    NEUROTESSMESH_API
+    std::vector< unsigned int >
+    neuronsInRegion( const std::vector< Eigen::Vector2f >& region_ ,
+                     int width_ , int height_ );
+
+    /**
+     * Method to project the somata of the given neurons to the viewport
+     * @param ids_ neuron ids
+     * @param width_ viewport width
+     * @param height_ viewport height
+     * @return soma positions in pixels from the top left corner, of the
+     * neurons in front of the camera
+     */
+    NEUROTESSMESH_API
+    std::vector< Eigen::Vector2f >
+    somaPositions( const std::vector< unsigned int >& ids_ ,
+                   int width_ , int height_ ) const;
+
+    /**
+     * Method to set the clipping planes. Neurons whose bounds are outside
+     * any of the planes are not rendered
+     * @param planes_ planes ( a, b, c, d ) keeping a*x + b*y + c*z + d >= 0,
+     * empty to disable clipping
+     */
+    NEUROTESSMESH_API
+    void clippingPlanes( const NeuronPicker::Planes& planes_ );
+
+    /**
+     * Method to get the clipping planes
+     * @return clipping planes, empty if clipping is disabled
+     */
+    NEUROTESSMESH_API
+    const NeuronPicker::Planes& clippingPlanes( ) const;
+
+    /**
+     * Method to show only the neurons inside an axis aligned slab
+     * @param axis_ slab normal axis, 0 for x, 1 for y and 2 for z
+     * @param minimum_ slab start along the axis
+     * @param maximum_ slab end along the axis
+     */
+    NEUROTESSMESH_API
+    void slab( unsigned int axis_ , float minimum_ , float maximum_ );
+
+    /**
+     * Method to enable the occlusion culling. The neurons visible in the
+     * previous frame are drawn first and the bounds of the rest are tested
+     * against the depth of the previous frame, so hidden neurons aren't
+     * tessellated
+     * @param occlusionCulling_ true to enable occlusion culling
+     */
+    NEUROTESSMESH_API
+    void occlusionCulling( bool occlusionCulling_ );
+
+    /**
+     * Method to get if the occlusion culling is enabled
+     * @return true if the occlusion culling is enabled
+     */
+    NEUROTESSMESH_API
+    bool occlusionCulling( ) const;
+
+    /**
+     * Method to know if the occlusion culling visible set is still
+     * changing, as its depth is read back a frame later
+     * @return true if the next frames are needed to settle it
+     */
+    NEUROTESSMESH_API
+    bool occlusionPending( ) const;
+
+    /**
+     * Method to set the opacity of the unselected neurons. Translucent
+     * unselected neurons are rendered to an offscreen layer composited
+     * over the selected ones, so only their nearest surface is blended
+     * @param alpha_ opacity between 0 and 1
+     */
+    NEUROTESSMESH_API
+    void unselectedAlpha( float alpha_ );
+
+    /**
+     * Method to get the opacity of the unselected neurons
+     * @return opacity between 0 and 1
+     */
+    NEUROTESSMESH_API
+    float unselectedAlpha( ) const;
+
+    /**
+     * Method to get the picking structure of the neurons
+     * @return neuron picker
+     */
+    NEUROTESSMESH_API
+    const NeuronPicker& neuronPicker( ) const;
+
+    /**
+     * Method to generate the meshes associated to the loaded neurons. Lazy
+     * generation or a memory budget leave them to update( )
      */
     NEUROTESSMESH_API
     void generateMeshes( );
 
+    /**
+     * Method to enable or disable the on-demand generation of the neuron
+     * meshes. In lazy mode a neuron mesh is generated the first time the
+     * neuron is visible, selected or edited and a soma placeholder is drawn
+     * until then. Disabling it generates all the missing meshes.
+     * @param lazy_ true to generate the meshes on demand
+     */
+    NEUROTESSMESH_API
+    void lazyMeshGeneration( bool lazy_ );
+
+    NEUROTESSMESH_API
+    bool lazyMeshGeneration( ) const;
+
+    /**
+     * Method to set the GPU memory budget of the neuron meshes. When exceeded
+     * the meshes chosen by the eviction policy are released and a soma
+     * placeholder is drawn until they are visible again and regenerated.
+     * @param bytes_ memory limit in bytes, 0 for no limit
+     */
+    NEUROTESSMESH_API
+    void meshMemoryLimit( size_t bytes_ );
+
+    NEUROTESSMESH_API
+    size_t meshMemoryLimit( ) const;
+
+    /**
+     * Method to get the estimated GPU memory used by the neuron meshes
+     * @return memory in bytes
+     */
+    NEUROTESSMESH_API
+    size_t meshMemoryUsage( ) const;
+
+    /**
+     * Method to set the policy used to choose the meshes released when over
+     * the memory budget.
+     * @param policy_ eviction policy
+     */
+    NEUROTESSMESH_API
+    void meshEvictionPolicy( MeshResidencyManager::EvictionPolicy policy_ );
+
+    /**
+     * Method to get the residency state of the neuron meshes
+     * @return mesh residency manager
+     */
+    NEUROTESSMESH_API
+    const MeshResidencyManager& meshResidency( ) const;
+
+    /**
+     * Method to know if visible or selected meshes are still waiting to be
+     * generated by update( ).
+     * @return true if more frames are needed to generate them
+     */
+    NEUROTESSMESH_API
+    bool meshesPending( ) const;
+
+    /**
+     * Method to simplify the morphologies that still don't have a mesh, so
+     * all the dataset morphologies are ready for meshing.
+     */
+    NEUROTESSMESH_API
+    void simplifyMorphologies( );
+
     /**
      * Method to set the render options of unseletected and selected neurons
      * @param paint_ option of neuron render
@@ -190,6 +402,13 @@ namespace neurotessmesh
     NEUROTESSMESH_API
     void levelOfDetail( float lod_ );
 
+    /**
+     * Method to get the scene level of subdivision
+     * @return scene level of detail
+     */
+    NEUROTESSMESH_API
+    float levelOfDetail( ) const;
+
     /**
      * Method to set the scene maximum subdivision distance
      * @param maximumDistance_ scene maximum subdivision distance
@@ -221,12 +440,65 @@ namespace neurotessmesh
     void regenerateEditNeuronMesh( float alphaRadius ,
                                    const std::vector< float >& alphaNeurites_ );
 
+    /**
+     * Method to get the morphology of the neuron being edited
+     * @return edited morphology or nullptr if none
+     */
+    NEUROTESSMESH_API
+    nsol::NeuronMorphologyPtr editNeuronMorphology( ) const;
+
+    /**
+     * Method to swap in a mesh generated outside of the scene for the edited
+     * neuron. The mesh is uploaded and replaces the previous one in the
+     * render lists without rebuilding them. The scene takes ownership of the
+     * mesh, which is deleted if the edited neuron has changed meanwhile.
+     * @param morphology_ morphology the mesh was generated from
+     * @param mesh_ mesh with CPU data
+     * @param alphaRadius_ soma radius factor used to generate the mesh
+     * @param alphaNeurites_ neurite factors used to generate the mesh
+     * @return true if the mesh has been used
+     */
+    NEUROTESSMESH_API
+    bool replaceEditNeuronMesh( nsol::NeuronMorphologyPtr morphology_ ,
+                                nlgeometry::MeshPtr mesh_ ,
+                                float alphaRadius_ ,
+                                const std::vector< float >& alphaNeurites_ );
+
+    /**
+     * Method to reuse the edited neuron mesh generated with the given
+     * parameters, if it is the current one or one of the recently replaced.
+     * @param alphaRadius_ soma radius factor
+     * @param alphaNeurites_ neurite factors
+     * @return true if no generation is needed
+     */
+    NEUROTESSMESH_API
+    bool useCachedEditNeuronMesh( float alphaRadius_ ,
+                                  const std::vector< float >& alphaNeurites_ );
+
     NEUROTESSMESH_API
     bool isEditNeuronMeshExtraction( );
 
     NEUROTESSMESH_API
     void extractEditNeuronMesh( const std::string& path_ );
 
+    /**
+     * Method to extract the tessellated mesh of a neuron in world
+     * coordinates, with the current render options of its selection state.
+     * Requires the GL context to be current. The caller owns the mesh. A
+     * mesh not resident is generated for the extraction and released
+     * @param id_ neuron id
+     * @return extracted mesh or nullptr if the neuron has no morphology
+     */
+    NEUROTESSMESH_API
+    nlgeometry::MeshPtr extractNeuronMesh( unsigned int id_ );
+
+    /**
+     * Method to get the ids of the selected neurons
+     * @return selected ids
+     */
+    NEUROTESSMESH_API
+    const std::set< unsigned int >& selectedIndices( ) const;
+
     NEUROTESSMESH_API
     void conformRenderTuples( );
 
@@ -275,7 +547,8 @@ namespace neurotessmesh
      */
     std::vector< Eigen::Vector3f > calculateUnselectedColors( float timestamp );
 
-    /** \brief Helper method that builds _neuronColors vector.
+    /** \brief Helper method that builds the colors of the render tuples
+     * entries, in the same order. Called by conformRenderTuples.
      *
      */
     void rebuildNeuronsColors();
@@ -286,6 +559,133 @@ namespace neurotessmesh
      */
     void initColors();
 
+    /** \brief Simplifies the given morphology once, unless already simplified.
+     * \param[in] morphology Neuron morphology.
+     *
+     */
+    void simplifyMorphology( nsol::NeuronMorphologyPtr morphology );
+
+    /** \brief Generates, uploads and registers the mesh of the given
+     * morphology if it doesn't exist.
+     * \param[in] morphology Neuron morphology.
+     * \returns The morphology mesh.
+     *
+     */
+    nlgeometry::MeshPtr ensureMesh( nsol::NeuronMorphologyPtr morphology );
+
+    /** \brief Removes the mesh of the given morphology.
+     * \param[in] morphology Neuron morphology.
+     *
+     */
+    void releaseMesh( nsol::NeuronMorphologyPtr morphology );
+
+    /** \brief Generates the missing meshes of the visible neurons and
+     * releases meshes when over the memory budget.
+     * \returns true if any mesh has been generated or released.
+     *
+     */
+    bool updateResidentMeshes( );
+
+    /** \brief Creates the placeholder mesh if it doesn't exist.
+     *
+     */
+    void createPlaceholder( );
+
+    /** \brief Computes the model matrix of the placeholder of the given
+     * neuron.
+     * \param[in] neuron Neuron.
+     * \param[out] model_ Placeholder model matrix.
+     * \return false if the neuron has no soma to place it.
+     *
+     */
+    bool placeholderModel( const nsol::NeuronPtr neuron ,
+                           Eigen::Matrix4f& model_ ) const;
+
+    /** \brief Edit neuron mesh and the parameters used to generate it.
+     *
+     */
+    struct EditMeshEntry
+    {
+      float alphaRadius;
+      std::vector< float > alphaNeurites;
+      nlgeometry::MeshPtr mesh;
+      size_t bytes;
+    };
+
+    /** \brief Makes the given uploaded mesh the edited neuron mesh, keeping
+     * the previous one in the edit mesh cache.
+     * \param[in] entry Mesh and generation parameters.
+     *
+     */
+    void swapEditMesh( const EditMeshEntry& entry );
+
+    /** \brief Deletes the cached edit meshes and forgets the parameters of
+     * the current one.
+     *
+     */
+    void clearEditMeshCache( );
+
+    /** \brief Deletes the oldest cached edit meshes while the memory budget
+     * is exceeded, and accounts the rest as reserved memory.
+     *
+     */
+    void trimEditMeshCache( );
+
+    /** \brief Rebuilds the render tuples and colors of the neurons not
+     * culled by the clipping planes.
+     *
+     */
+    void updateClipping( );
+
+    /** \brief Draw call of the render queue. The neurons of both sets
+     * painted with the same programs are drawn together.
+     *
+     */
+    struct RenderPass
+    {
+      NeuronMeshes neurons;
+      std::vector< Eigen::Vector3f > colors;
+      //! Render queue items of the neurons, to look up per frame colors
+      std::vector< size_t > items;
+      bool soma;
+      bool neurites;
+    };
+
+    /** \brief Builds the passes drawing the given entries of the unselected
+     * and selected render tuples in render queue order. A single pass is
+     * used when both sets paint the same pieces, otherwise a soma and a
+     * neurites pass.
+     * \param[in] unselectedEntries_ Unselected entries, or null for all.
+     * \param[in] selectedEntries_ Selected entries, or null for all.
+     * \param[out] passes_ Render passes.
+     *
+     */
+    void buildRenderPasses( const std::vector< size_t >* unselectedEntries_ ,
+                            const std::vector< size_t >* selectedEntries_ ,
+                            std::vector< RenderPass >& passes_ ) const;
+
+    /** \brief Renders the given entries of the unselected and selected
+     * render tuples. With a translucent context the selected neurons are
+     * drawn first and the unselected layer is composited over them, so it
+     * has to be called once per frame with all the entries to draw.
+     * \param[in] unselectedEntries_ Unselected entries, or null to render
+     * all the neurons not clipped.
+     * \param[in] selectedEntries_ Selected entries, or null to render all
+     * the neurons not clipped.
+     *
+     */
+    void renderNeurons( const std::vector< size_t >* unselectedEntries_ ,
+                        const std::vector< size_t >* selectedEntries_ );
+
+    /** \brief Renders the neurons visible in the previous frame and the
+     * ones disoccluded now, culling the neurons hidden in the depth read back
+     * from the previous frames. Both sets are drawn with one renderNeurons
+     * call.
+     * \param[in] viewProjection_ Current projection and view matrices.
+     *
+     */
+    void renderOccluded( const Eigen::Matrix4f& viewProjection_ );
+
     //! Scene mode
     TSceneMode _mode;
 
@@ -299,7 +699,10 @@ namespace neurotessmesh
     //! Neurolots engine to render morphological data
     nlrender::Renderer* _renderer;
 
-    //! Meshes attribs format
+    //! Meshes attribs format, full float3 position, center and tangent.
+    //! A compact layout (16-bit positions and centers relative to the mesh
+    //! bounds, octahedral tangents) needs new nlgeometry attribute types and
+    //! decoding in the nlrender tessellation shaders, both in neurolots.
     nlgeometry::AttribsFormat _attribsFormat;
 
     // Mesh colors
@@ -316,16 +719,83 @@ namespace neurotessmesh
     simil::SpikesPlayer* _simulationPlayer;
 #endif
 
+    //! True if the dataset morphologies don't need to be simplified
+    bool _simplifiedMorphologies;
+
     //! Neuron Meshes
     std::unordered_map< nsol::MorphologyPtr , nlgeometry::MeshPtr >
       _neuronMeshes;
 
+    //! Morphologies already simplified
+    std::unordered_set< nsol::MorphologyPtr > _preparedMorphologies;
+
+    //! On-demand mesh generation
+    bool _lazyMeshes;
+
+    //! GPU memory accounting of the neuron meshes
+    MeshResidencyManager _residency;
+
+    //! Selected morphologies waiting for their mesh
+    std::vector< nsol::NeuronMorphologyPtr > _pendingMeshes;
+
+    //! Visible or selected meshes left for the next frames
+    bool _meshesPending;
+
+    //! Unit sphere drawn in place of the neurons without a mesh
+    nsol::NeuronMorphologyPtr _placeholderMorphology;
+    nlgeometry::MeshPtr _placeholderMesh;
+
     //! Unselected neuron meshes
     NeuronMeshes _unselectedNeurons;
 
     //! Selected neuron meshes
     NeuronMeshes _selectedNeurons;
 
+    //! Neuron bounds positions of the render tuples entries
+    std::vector< long > _unselectedPositions;
+    std::vector< long > _selectedPositions;
+
+    //! Neuron ids of the render tuples entries, colors follow their order
+    std::vector< unsigned int > _unselectedIds;
+    std::vector< unsigned int > _selectedIds;
+
+    //! User clipping planes, empty if disabled
+    NeuronPicker::Planes _clippingPlanes;
+
+    //! Render tuples, colors and unselected entries not culled by the
+    //! clipping planes
+    NeuronMeshes _clippedUnselectedNeurons;
+    NeuronMeshes _clippedSelectedNeurons;
+    std::vector< Eigen::Vector3f > _clippedUnselectedColors;
+    std::vector< Eigen::Vector3f > _clippedSelectedColors;
+    std::vector< size_t > _clippedUnselectedEntries;
+    std::vector< size_t > _clippedSelectedEntries;
+    bool _clippingDirty;
+
+    //! Occlusion culling state, with the visible flags of the last frame
+    //! indexed by neuron bounds position
+    bool _occlusionCulling;
+    bool _occlusionPending;
+    OcclusionCuller _occlusionCuller;
+    DepthReadback _depthReadback;
+    std::vector< bool > _occlusionVisible;
+
+    //! Render queue, the unselected entries and then the selected ones
+    //! offset by the unselected count, grouped by mesh so the neurons
+    //! sharing a morphology are drawn consecutively
+    std::vector< size_t > _renderQueue;
+
+    //! Passes of the queue for the neurons not clipped
+    std::vector< RenderPass > _renderPasses;
+    bool _renderPassesDirty;
+
+    //! Opacity of the unselected neurons and their offscreen layer
+    float _unselectedAlpha;
+    TranslucentLayer _unselectedLayer;
+
+    //! Rendered image version, see version( )
+    unsigned long _version;
+
     //! List of selected indices
     std::set< unsigned int > _selectedIndices;
 
@@ -341,9 +811,22 @@ namespace neurotessmesh
     //! Neuron mesh to be edited
     nlgeometry::MeshPtr _editMesh;
 
+    //! Generation parameters of _editMesh, if known
+    EditMeshEntry _editParameters;
+    bool _editParametersValid;
+
+    //! Recently replaced edit meshes, most recent first
+    std::list< EditMeshEntry > _editMeshCache;
+
     //! Scene bonunding box
     nlgeometry::AxisAlignedBoundingBox _boundingBox;
 
+    //! Neuron world bounding boxes from their full morphologies
+    NeuronBounds _neuronBounds;
+
+    //! Ray casting hierarchy over _neuronBounds
+    NeuronPicker _neuronPicker;
+
     //! Activation timestamps.
     std::unordered_map< nlgeometry::MeshPtr , float > _activationTimestamps;
     Gradient _gradient;
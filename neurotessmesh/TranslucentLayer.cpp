@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "TranslucentLayer.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  // Full screen triangle generated from the vertex ids
+  const char* const VERTEX_SHADER = R"(#version 330 core
+out vec2 uv;
+void main( )
+{
+  uv = vec2(( gl_VertexID << 1 ) & 2 , gl_VertexID & 2 );
+  gl_Position = vec4( uv * 2.0 - 1.0 , 0.0 , 1.0 );
+})";
+
+  // The layer depth is kept so the depth test hides it behind the
+  // geometry already in the framebuffer.
+  const char* const FRAGMENT_SHADER = R"(#version 330 core
+uniform sampler2D colorTexture;
+uniform sampler2D depthTexture;
+uniform float alpha;
+in vec2 uv;
+out vec4 fragColor;
+void main( )
+{
+  float depth = texture( depthTexture , uv ).r;
+  if ( depth >= 1.0 )
+    discard;
+  fragColor = vec4( texture( colorTexture , uv ).rgb , alpha );
+  gl_FragDepth = depth;
+})";
+
+  GLuint compileShader( GLenum type , const char* source )
+  {
+    const auto shader = glCreateShader( type );
+    glShaderSource( shader , 1 , &source , nullptr );
+    glCompileShader( shader );
+
+    GLint status = GL_FALSE;
+    glGetShaderiv( shader , GL_COMPILE_STATUS , &status );
+    if ( status != GL_TRUE )
+    {
+      GLint length = 0;
+      glGetShaderiv( shader , GL_INFO_LOG_LENGTH , &length );
+      std::vector< char > log( static_cast< size_t >( std::max( length , 1 )));
+      glGetShaderInfoLog( shader , length , nullptr , log.data( ));
+      std::cerr << "Translucent layer shader error: " << log.data( ) << std::endl;
+      glDeleteShader( shader );
+      return 0;
+    }
+    return shader;
+  }
+}
+
+namespace neurotessmesh
+{
+  TranslucentLayer::TranslucentLayer( )
+    : _program( 0 )
+    , _vertexArray( 0 )
+    , _framebuffer( 0 )
+    , _colorTexture( 0 )
+    , _depthTexture( 0 )
+    , _alphaLocation( -1 )
+    , _width( 0 )
+    , _height( 0 )
+    , _failed( false )
+    , _previousFramebuffer( 0 )
+    , _viewport{ 0 , 0 , 0 , 0 }
+  {
+  }
+
+  bool TranslucentLayer::begin( )
+  {
+    if ( !initialize( ))
+      return false;
+
+    glGetIntegerv( GL_VIEWPORT , _viewport );
+    if ( !resize( _viewport[ 2 ] , _viewport[ 3 ]))
+      return false;
+
+    glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING , &_previousFramebuffer );
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER , _framebuffer );
+    glViewport( 0 , 0 , _width , _height );
+
+    GLfloat clearColor[ 4 ];
+    glGetFloatv( GL_COLOR_CLEAR_VALUE , clearColor );
+    glClearColor( 0.0f , 0.0f , 0.0f , 0.0f );
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    glClearColor( clearColor[ 0 ] , clearColor[ 1 ] , clearColor[ 2 ] ,
+                  clearColor[ 3 ]);
+    return true;
+  }
+
+  void TranslucentLayer::end( )
+  {
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER ,
+                       static_cast< GLuint >( _previousFramebuffer ));
+    glViewport( _viewport[ 0 ] , _viewport[ 1 ] , _viewport[ 2 ] , _viewport[ 3 ]);
+  }
+
+  void TranslucentLayer::composite( float alpha )
+  {
+    if ( !_program || !_framebuffer )
+      return;
+
+    GLint program = 0;
+    glGetIntegerv( GL_CURRENT_PROGRAM , &program );
+    GLboolean depthMask = GL_TRUE;
+    glGetBooleanv( GL_DEPTH_WRITEMASK , &depthMask );
+    const auto blend = glIsEnabled( GL_BLEND );
+    const auto depthTest = glIsEnabled( GL_DEPTH_TEST );
+    GLint blendSource = GL_ONE , blendDestination = GL_ZERO;
+    glGetIntegerv( GL_BLEND_SRC_RGB , &blendSource );
+    glGetIntegerv( GL_BLEND_DST_RGB , &blendDestination );
+
+    glEnable( GL_BLEND );
+    glBlendFunc( GL_SRC_ALPHA , GL_ONE_MINUS_SRC_ALPHA );
+    glEnable( GL_DEPTH_TEST );
+    glDepthMask( GL_FALSE );
+
+    glUseProgram( _program );
+    glUniform1f( _alphaLocation , alpha );
+    glActiveTexture( GL_TEXTURE1 );
+    glBindTexture( GL_TEXTURE_2D , _depthTexture );
+    glActiveTexture( GL_TEXTURE0 );
+    glBindTexture( GL_TEXTURE_2D , _colorTexture );
+
+    glBindVertexArray( _vertexArray );
+    glDrawArrays( GL_TRIANGLES , 0 , 3 );
+    glBindVertexArray( 0 );
+
+    glBindTexture( GL_TEXTURE_2D , 0 );
+    glActiveTexture( GL_TEXTURE1 );
+    glBindTexture( GL_TEXTURE_2D , 0 );
+    glActiveTexture( GL_TEXTURE0 );
+
+    glUseProgram( static_cast< GLuint >( program ));
+    glDepthMask( depthMask );
+    glBlendFunc( static_cast< GLenum >( blendSource ) ,
+                 static_cast< GLenum >( blendDestination ));
+    if ( !blend )
+      glDisable( GL_BLEND );
+    if ( !depthTest )
+      glDisable( GL_DEPTH_TEST );
+  }
+
+  void TranslucentLayer::release( )
+  {
+    if ( _framebuffer )
+      glDeleteFramebuffers( 1 , &_framebuffer );
+    if ( _colorTexture )
+      glDeleteTextures( 1 , &_colorTexture );
+    if ( _depthTexture )
+      glDeleteTextures( 1 , &_depthTexture );
+    if ( _vertexArray )
+      glDeleteVertexArrays( 1 , &_vertexArray );
+    if ( _program )
+      glDeleteProgram( _program );
+
+    _framebuffer = _colorTexture = _depthTexture = 0;
+    _vertexArray = _program = 0;
+    _width = _height = 0;
+  }
+
+  bool TranslucentLayer::initialize( )
+  {
+    if ( _program )
+      return true;
+    if ( _failed )
+      return false;
+
+    const auto vertexShader = compileShader( GL_VERTEX_SHADER , VERTEX_SHADER );
+    const auto fragmentShader =
+      compileShader( GL_FRAGMENT_SHADER , FRAGMENT_SHADER );
+    if ( !vertexShader || !fragmentShader )
+    {
+      glDeleteShader( vertexShader );
+      glDeleteShader( fragmentShader );
+      _failed = true;
+      return false;
+    }
+
+    _program = glCreateProgram( );
+    glAttachShader( _program , vertexShader );
+    glAttachShader( _program , fragmentShader );
+    glLinkProgram( _program );
+    glDeleteShader( vertexShader );
+    glDeleteShader( fragmentShader );
+
+    GLint status = GL_FALSE;
+    glGetProgramiv( _program , GL_LINK_STATUS , &status );
+    if ( status != GL_TRUE )
+    {
+      std::cerr << "Translucent layer shader link error" << std::endl;
+      glDeleteProgram( _program );
+      _program = 0;
+      _failed = true;
+      return false;
+    }
+
+    GLint program = 0;
+    glGetIntegerv( GL_CURRENT_PROGRAM , &program );
+    glUseProgram( _program );
+    glUniform1i( glGetUniformLocation( _program , "colorTexture" ) , 0 );
+    glUniform1i( glGetUniformLocation( _program , "depthTexture" ) , 1 );
+    _alphaLocation = glGetUniformLocation( _program , "alpha" );
+    glUseProgram( static_cast< GLuint >( program ));
+
+    // Core profiles need a vertex array even without attributes
+    glGenVertexArrays( 1 , &_vertexArray );
+    return true;
+  }
+
+  bool TranslucentLayer::resize( int width , int height )
+  {
+    if ( width <= 0 || height <= 0 )
+      return false;
+    if ( _framebuffer && width == _width && height == _height )
+      return true;
+
+    if ( !_framebuffer )
+    {
+      glGenFramebuffers( 1 , &_framebuffer );
+      glGenTextures( 1 , &_colorTexture );
+      glGenTextures( 1 , &_depthTexture );
+    }
+
+    GLint texture = 0;
+    glGetIntegerv( GL_TEXTURE_BINDING_2D , &texture );
+    auto setup = [ width , height ]( GLuint name , GLint format ,
+                                     GLenum pixelFormat , GLenum type )
+    {
+      glBindTexture( GL_TEXTURE_2D , name );
+      glTexImage2D( GL_TEXTURE_2D , 0 , format , width , height , 0 ,
+                    pixelFormat , type , nullptr );
+      glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_MIN_FILTER , GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_MAG_FILTER , GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_WRAP_S , GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D , GL_TEXTURE_WRAP_T , GL_CLAMP_TO_EDGE );
+    };
+    setup( _colorTexture , GL_RGBA8 , GL_RGBA , GL_UNSIGNED_BYTE );
+    setup( _depthTexture , GL_DEPTH_COMPONENT24 , GL_DEPTH_COMPONENT , GL_FLOAT );
+    glBindTexture( GL_TEXTURE_2D , static_cast< GLuint >( texture ));
+
+    GLint framebuffer = 0;
+    glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING , &framebuffer );
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER , _framebuffer );
+    glFramebufferTexture2D( GL_DRAW_FRAMEBUFFER , GL_COLOR_ATTACHMENT0 ,
+                            GL_TEXTURE_2D , _colorTexture , 0 );
+    glFramebufferTexture2D( GL_DRAW_FRAMEBUFFER , GL_DEPTH_ATTACHMENT ,
+                            GL_TEXTURE_2D , _depthTexture , 0 );
+    const auto status = glCheckFramebufferStatus( GL_DRAW_FRAMEBUFFER );
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER , static_cast< GLuint >( framebuffer ));
+
+    if ( status != GL_FRAMEBUFFER_COMPLETE )
+    {
+      std::cerr << "Translucent layer framebuffer incomplete" << std::endl;
+      release( );
+      _failed = true;
+      return false;
+    }
+
+    _width = width;
+    _height = height;
+    return true;
+  }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 VG-Lab/URJC.
+ *
+ * This file is part of NeuroTessMesh <https://github.com/vg-lab/neurotessmesh>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEUROTESSMESH_TRANSLUCENTLAYER_H_
+#define NEUROTESSMESH_TRANSLUCENTLAYER_H_
+
+// C++
+#include <string>
+
+namespace neurotessmesh
+{
+  /** \class TranslucentLayer
+   * \brief Offscreen layer composited with a constant opacity.
+   *
+   * The geometry rendered between begin and end goes to its own color and
+   * depth textures. The composite pass blends the layer over the current
+   * framebuffer where it's in front of the geometry already there, so a
+   * whole set of meshes is faded with a single full screen pass and without
+   * any sorting. Only the nearest layer surface is kept, which is what the
+   * context of a selection needs. Requires a current OpenGL context.
+   *
+   */
+  class TranslucentLayer
+  {
+  public:
+    TranslucentLayer( );
+
+    /** \brief Redirects the rendering to the layer, sized as the viewport.
+     * \returns false if the layer can't be used in the current context.
+     *
+     */
+    bool begin( );
+
+    /** \brief Restores the framebuffer bound before begin.
+     *
+     */
+    void end( );
+
+    /** \brief Blends the layer over the current framebuffer.
+     * \param[in] alpha Layer opacity.
+     *
+     */
+    void composite( float alpha );
+
+    /** \brief Releases the GL resources. Requires the context where they
+     * were created to be current.
+     *
+     */
+    void release( );
+
+  private:
+    bool initialize( );
+
+    bool resize( int width , int height );
+
+    unsigned int _program;
+    unsigned int _vertexArray;
+    unsigned int _framebuffer;
+    unsigned int _colorTexture;
+    unsigned int _depthTexture;
+    int _alphaLocation;
+    int _width;
+    int _height;
+    bool _failed;
+
+    //! State saved by begin
+    int _previousFramebuffer;
+    int _viewport[ 4 ];
+  };
+}
+
+#endif /* NEUROTESSMESH_TRANSLUCENTLAYER_H_ */
@@ -51,9 +51,15 @@ int main( int argc, char** argv )
   std::string swcFile;
   std::string sceneFile;
   std::string hdf5File;
+  std::string snapshotFile;
   std::string zeqUri;
   std::string target = std::string( "" );
   bool fullscreen = false, initWindowSize = false, initWindowMaximized = false;
+  bool lazyMeshes = false;
+  bool renderPath = false;
+  neurotessmesh::CameraPathRenderer::Options renderOptions;
+  bool benchmark = false;
+  neurotessmesh::FrameBenchmark::Options benchmarkOptions;
   int initWindowWidth = 0, initWindowHeight = 0;
 
 
@@ -61,6 +67,8 @@ int main( int argc, char** argv )
   int ctxOpenGLMinor = DEFAULT_CONTEXT_OPENGL_MINOR;
   int ctxOpenGLSamples = 16;
   int ctxOpenGLVSync = 1;
+  float interactiveScale = 0.5f;
+  int interactiveSamples = 4;
 
 
   for( int i = 1; i < argc; i++ )
@@ -125,6 +133,13 @@ int main( int argc, char** argv )
       else
         usageMessage(programName);
     }
+    if( std::strcmp(argv[i], "-snap") == 0 )
+    {
+      if(++i < argc)
+        snapshotFile = std::string (argv[i]);
+      else
+        usageMessage(programName);
+    }
 
     if( std::strcmp( argv[ i ], "-target" ) == 0 )
     {
@@ -173,11 +188,117 @@ int main( int argc, char** argv )
       ctxOpenGLSamples = atoi( argv[ ++i ] );
 
     }
+    if ( strcmp( argv[i], "--interactive-scale" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      interactiveScale = atof( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--interactive-samples" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      interactiveSamples = atoi( argv[ ++i ] );
+    }
     if ( strcmp( argv[i], "--no-vsync" ) == 0 ||
          strcmp( argv[i],"-nvs") == 0 )
     {
       ctxOpenGLVSync = 0;
     }
+    if ( strcmp( argv[i], "--lazy-meshes" ) == 0 ||
+         strcmp( argv[i],"-lm") == 0 )
+    {
+      lazyMeshes = true;
+    }
+    if ( strcmp( argv[i], "--render-path" ) == 0 )
+    {
+      if ( i + 2 >= argc )
+        usageMessage(programName);
+      renderPath = true;
+      renderOptions.positionsFile = QString::fromLocal8Bit( argv[ ++i ] );
+      renderOptions.output = QString::fromLocal8Bit( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--render-size" ) == 0 )
+    {
+      if ( i + 2 >= argc )
+        usageMessage(programName);
+      const int width = atoi( argv[ ++i ] );
+      const int height = atoi( argv[ ++i ] );
+      renderOptions.size = QSize( width, height );
+    }
+    if ( strcmp( argv[i], "--render-fps" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      renderOptions.fps = atof( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--render-seconds" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      renderOptions.secondsPerPosition = atof( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--render-encoder" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      renderOptions.encoder = QString::fromLocal8Bit( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--benchmark" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      benchmark = true;
+      benchmarkOptions.positionsFile = QString::fromLocal8Bit( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--benchmark-output" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      benchmarkOptions.output = QString::fromLocal8Bit( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--benchmark-baseline" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      benchmarkOptions.baseline = QString::fromLocal8Bit( argv[ ++i ] );
+    }
+    if ( strcmp( argv[i], "--benchmark-tolerance" ) == 0 )
+    {
+      if ( i + 1 >= argc )
+        usageMessage(programName);
+      benchmarkOptions.tolerance = atof( argv[ ++i ] );
+    }
+  }
+
+  if ( renderPath && benchmark )
+  {
+    std::cerr << "Error: --render-path and --benchmark are exclusive"
+              << std::endl;
+    usageMessage(programName);
+  }
+
+  if ( benchmark )
+  {
+    if ( blueConfig.empty( ) && swcFile.empty( ) && sceneFile.empty( ) &&
+         hdf5File.empty( ) && snapshotFile.empty( ))
+    {
+      std::cerr << "Error: --benchmark requires a dataset" << std::endl;
+      usageMessage(programName);
+    }
+
+    // Frames are rendered offscreen and timed, never presented
+    ctxOpenGLVSync = 0;
+    benchmarkOptions.size = renderOptions.size;
+    benchmarkOptions.fps = renderOptions.fps;
+    benchmarkOptions.secondsPerPosition = renderOptions.secondsPerPosition;
+  }
+
+  if ( renderPath && blueConfig.empty( ) && swcFile.empty( ) &&
+       sceneFile.empty( ) && hdf5File.empty( ) && snapshotFile.empty( ))
+  {
+    std::cerr << "Error: --render-path requires a dataset" << std::endl;
+    usageMessage(programName);
   }
 
   if ( setFormat( ctxOpenGLMajor, ctxOpenGLMinor,
@@ -197,6 +318,12 @@ int main( int argc, char** argv )
 
     mainWindow->show( );
     mainWindow->init( zeqUri );
+    mainWindow->lazyMeshGeneration( lazyMeshes );
+    mainWindow->interactiveQuality( interactiveScale, interactiveSamples );
+    if ( renderPath )
+      mainWindow->renderCameraPath( renderOptions );
+    if ( benchmark )
+      mainWindow->benchmark( benchmarkOptions );
    
     if ( atLeastTwo( !blueConfig.empty( ),
                      !swcFile.empty( ),
@@ -218,6 +345,9 @@ int main( int argc, char** argv )
       
     if(!hdf5File.empty())
       mainWindow->openHDF5File (hdf5File);
+
+    if(!snapshotFile.empty())
+      mainWindow->openSnapshot (snapshotFile);
   }
   else
   {
@@ -247,7 +377,8 @@ void usageMessage(const char* progName)
             << "Usage: "
             << progName << std::endl
             << "\t[ -bc blue_config_path | -swc swc_file_list "
-            << " | -xml scene_xml | -h5 hdf5_file_path ] "
+            << " | -xml scene_xml | -h5 hdf5_file_path "
+            << "| -snap snapshot_file ] "
             << std::endl
             << "\t[ -target target_label ] "
             << std::endl
@@ -263,6 +394,30 @@ void usageMessage(const char* progName)
             << std::endl
             << "\t[ -nvs | --no-vsync ] (2)"
             << std::endl
+            << "\t[ --interactive-scale factor ] (0.5) (6)"
+            << std::endl
+            << "\t[ --interactive-samples num_samples ] (4)"
+            << std::endl
+            << "\t[ -lm | --lazy-meshes ]"
+            << std::endl
+            << "\t[ --render-path positions_json output_dir ] (5)"
+            << std::endl
+            << "\t[ --render-size width height ] (1920 1080)"
+            << std::endl
+            << "\t[ --render-fps frames_per_second ] (30)"
+            << std::endl
+            << "\t[ --render-seconds seconds_per_position ] (2)"
+            << std::endl
+            << "\t[ --render-encoder \"command\" ]"
+            << std::endl
+            << "\t[ --benchmark positions_json ] (7)"
+            << std::endl
+            << "\t[ --benchmark-output results_json ]"
+            << std::endl
+            << "\t[ --benchmark-baseline results_json ]"
+            << std::endl
+            << "\t[ --benchmark-tolerance fraction ] (0.1)"
+            << std::endl
             << "\t[ -cv | --context-version ] major minor (3)"
             << std::endl
             << "\t[ --version ]"
@@ -278,6 +433,30 @@ void usageMessage(const char* progName)
             << "\t    overwritten by env var CONTEXT_OPENGL_MINOR"
             << std::endl
             << "\t(4) schema: for example hbp://"
+            << std::endl
+            << "\t(5) renders the camera path at a fixed frame rate to"
+            << " numbered PNG images, or pipes PPM frames to the encoder"
+            << std::endl
+            << "\t    standard input (e.g. \"ffmpeg -f image2pipe -c:v ppm"
+            << " -i - video.mp4\"), and quits"
+            << std::endl
+            << "\t(6) resolution of the frames rendered while the camera"
+            << " moves, 1 renders them at full quality"
+            << std::endl
+            << "\t(7) times the frames along the camera path, sampled as with"
+            << " --render-path and without vsync,"
+            << std::endl
+            << "\t    writes their min, median, p95 and p99 in ms as JSON to"
+            << " stdout or the output file and quits."
+            << std::endl
+            << "\t    Exits with 2 if the median or p95 are slower than the"
+            << " baseline beyond the tolerance,"
+            << std::endl
+            << "\t    the baseline must come from the same renderer, size and"
+            << " samples."
+            << std::endl
+            << "\t    Runs on Mesa llvmpipe with LIBGL_ALWAYS_SOFTWARE=1"
+            << " (e.g. under xvfb-run)"
             << std::endl << std::endl;
   exit(-1);
 }
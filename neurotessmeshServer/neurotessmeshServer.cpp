@@ -1,4 +1,8 @@
 #include <iostream>
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
 #include <boost/filesystem.hpp>
 
 #include <nlgeometry/nlgeometry.h>
@@ -8,6 +12,8 @@
 #include <nsol/nsol.h>
 
 #include <neurotessmeshServer/version.h>
+#include <neurotessmesh/BinaryMeshWriter.h>
+#include <neurotessmesh/MeshPostProcessor.h>
 
 //OpenGL
 #ifndef NEUROLOTS_SKIP_GLEW_INCLUDE
@@ -29,8 +35,13 @@ void helpMessage( const std::string& appName_ )
 {
   std::cerr << "Usage:\n\n" << appName_ << "[options] morphology_files[.swc]\n"
             << "  Options:\n\n    -l [float] sets the level of subdivisiones "
-            << "per unit of measure for the output mesh.\n    -f [obj|off] sets"
-            << " the output format file: obj or off file format" << std::endl;
+            << "per unit of measure for the output mesh.\n    -f [obj|off|ply|glb] sets"
+            << " the output format file: obj, off, binary ply or glTF binary"
+            << " file format\n    -w [float] welds the vertices closer than"
+            << " the given distance (ply and glb only)\n    -r [float] decimates"
+            << " the mesh keeping the given fraction of triangles (ply and glb"
+            << " only)\n    -e [float] decimates the mesh up to the given"
+            << " geometric error (ply and glb only)" << std::endl;
 }
 
 void errorMessage( const std::string& appName_ )
@@ -58,12 +69,22 @@ int main( int argc, char** argv )
   int filesStart = 1;
   float lod = 1.0f;
   unsigned int outFormat = 0;
+  neurotessmesh::MeshPostProcessor::Options postProcessing;
   std::string appName( argv[0] );
   for ( int i = 1; i < argc; i++ )
   {
     std::string option( argv[i]);
     try
     {
+      // Options followed by a value
+      if (( option.compare( "-l" ) == 0 || option.compare( "-f" ) == 0 ||
+            option.compare( "-w" ) == 0 || option.compare( "-r" ) == 0 ||
+            option.compare( "-e" ) == 0 ) && i + 1 >= argc )
+      {
+        errorMessage( appName );
+        return 1;
+      }
+
       if ( option.compare( "-h" ) == 0 || option.compare( "--help" ) == 0 )
       {
         helpMessage( appName );
@@ -75,6 +96,25 @@ int main( int argc, char** argv )
         ++i;
         filesStart += 2;
       }
+      else if ( option.compare( "-w" ) == 0 )
+      {
+        postProcessing.weld = true;
+        postProcessing.weldTolerance = std::atof( argv[i+1] );
+        ++i;
+        filesStart += 2;
+      }
+      else if ( option.compare( "-r" ) == 0 )
+      {
+        postProcessing.triangleRatio = std::atof( argv[i+1] );
+        ++i;
+        filesStart += 2;
+      }
+      else if ( option.compare( "-e" ) == 0 )
+      {
+        postProcessing.maxError = std::atof( argv[i+1] );
+        ++i;
+        filesStart += 2;
+      }
       else if ( option.compare( "-f" ) == 0 )
       {
         std::string outFormatOption( argv[i+1] );
@@ -88,6 +128,14 @@ int main( int argc, char** argv )
         {
           outFormat = 1;
         }
+        else if ( outFormatOption.compare( "ply" ) == 0 )
+        {
+          outFormat = 2;
+        }
+        else if ( outFormatOption.compare( "glb" ) == 0 )
+        {
+          outFormat = 3;
+        }
       }
     }
     catch( ... )
@@ -116,6 +164,12 @@ int main( int argc, char** argv )
 
   nsol::SwcReader swcr;
 
+  // Binary meshes are post-processed and written in parallel with the
+  // generation of the next ones.
+  std::deque< std::future< void >> writers;
+  const size_t maxWriters =
+    std::max( 1u, std::thread::hardware_concurrency( ));
+
   for ( int i = filesStart; i < argc; i++ )
   {
     std::string inFile( argv[i] );
@@ -149,6 +203,41 @@ int main( int argc, char** argv )
         nlgeometry::OffWriter::writeMesh(
           renderer.extract( mesh, mesh->modelMatrix( )), outFile, header );
       }
+      else
+      {
+        const bool ply = outFormat == 2;
+        std::string outFile = boost::filesystem::path( inFile
+          ).replace_extension( ply ? "ply" : "glb" ).string( );
+        auto extracted = renderer.extract( mesh, mesh->modelMatrix( ));
+        auto indexed = std::make_shared< neurotessmesh::IndexedMesh >(
+          neurotessmesh::IndexedMesh::fromMesh( extracted ));
+        delete extracted;
+
+        if ( writers.size( ) >= maxWriters )
+        {
+          writers.front( ).wait( );
+          writers.pop_front( );
+        }
+        writers.push_back( std::async( std::launch::async,
+          [ indexed, outFile, header, ply, postProcessing ]( )
+          {
+            try
+            {
+              neurotessmesh::MeshPostProcessor::process( *indexed,
+                                                         postProcessing );
+              if ( ply )
+                neurotessmesh::BinaryMeshWriter::writePLY(
+                  *indexed, outFile, header );
+              else
+                neurotessmesh::BinaryMeshWriter::writeGLB( *indexed, outFile );
+            }
+            catch( const std::exception& e )
+            {
+              std::cerr << "Error writing " << outFile << ": " << e.what( )
+                        << std::endl;
+            }
+          }));
+      }
       delete mesh;
       delete morphology;
     }
@@ -158,6 +247,9 @@ int main( int argc, char** argv )
     }
   }
 
+  for ( auto& writer: writers )
+    writer.wait( );
+
 
   return 0;
 }